@@ -0,0 +1,179 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
+#include <governance/governance.h>
+#include <index/txindex.h>
+#include <key.h>
+#include <key_io.h>
+#include <miner.h>
+#include <pow.h>
+#include <scheduler.h>
+#include <txdb.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <boost/thread.hpp>
+
+static const int NUM_VOTE_UTXOS{20};
+static const int NUM_PROPOSALS{2};
+static const int NUM_VOTE_BLOCKS{30};
+
+static CBlock MineBlock(const CScript& coinbase_scriptPubKey, const std::vector<CMutableTransaction>& txns = {})
+{
+    auto block = std::make_shared<CBlock>(BlockAssembler{Params()}.CreateNewBlock(coinbase_scriptPubKey)->block);
+    block->vtx.resize(1);
+    for (const auto & tx : txns)
+        block->vtx.push_back(MakeTransactionRef(tx));
+    block->nTime = ::chainActive.Tip()->GetMedianTimePast() + 1;
+    block->hashMerkleRoot = BlockMerkleRoot(*block);
+    while (!CheckProofOfWork(block->GetHash(), block->nBits, Params().GetConsensus())) {
+        ++block->nNonce;
+        assert(block->nNonce);
+    }
+    bool processed{ProcessNewBlock(Params(), block, true, nullptr)};
+    assert(processed);
+    return *block;
+}
+
+static CScript GovernanceScript(const CDataStream& ss)
+{
+    return CScript() << OP_RETURN << ToByteVector(ss);
+}
+
+// Chain with proposals and votes. Vote utxos are P2PKH coinbases, every vote block
+// changes the votes of all utxos on all proposals. Fees are paid from a chain of
+// OP_TRUE outputs, the vote's vin hash commits to the spent fee output.
+static void CreateGovernanceChain(const Consensus::Params& consensus)
+{
+    const CScript SCRIPT_PUB{CScript(OP_TRUE)};
+    CKey key; key.MakeNewKey(true);
+    const CScript voteScript = GetScriptForDestination(key.GetPubKey().GetID());
+
+    const auto fundBlock = MineBlock(SCRIPT_PUB);
+    std::vector<COutPoint> voteUtxos;
+    for (int i = 0; i < NUM_VOTE_UTXOS; ++i)
+        voteUtxos.emplace_back(MineBlock(voteScript).vtx[0]->GetHash(), 0);
+    while (::chainActive.Height() <= consensus.coinMaturity + 1) // fund coinbase must mature
+        MineBlock(SCRIPT_PUB);
+
+    // Proposals
+    COutPoint fee(fundBlock.vtx[0]->GetHash(), 0);
+    CAmount feeAmount = fundBlock.vtx[0]->vout[0].nValue;
+    std::vector<gov::Proposal> proposals;
+    {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(fee);
+        for (int i = 0; i < NUM_PROPOSALS; ++i) {
+            gov::Proposal proposal(strprintf("Bench proposal %d", i), consensus.superblock, 100 * COIN,
+                                   EncodeDestination(key.GetPubKey().GetID()), "https://blocknet.co", "Bench");
+            CDataStream ss(SER_NETWORK, GOV_PROTOCOL_VERSION);
+            ss << proposal;
+            tx.vout.emplace_back(consensus.proposalFee, GovernanceScript(ss));
+            feeAmount -= consensus.proposalFee;
+            proposals.push_back(proposal);
+        }
+        feeAmount -= COIN;
+        tx.vout.emplace_back(feeAmount, SCRIPT_PUB);
+        fee = COutPoint(tx.GetHash(), tx.vout.size() - 1);
+        MineBlock(SCRIPT_PUB, {tx});
+    }
+
+    // Votes
+    for (int i = 0; i < NUM_VOTE_BLOCKS; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(fee);
+        const auto vinHash = gov::makeVinHash(fee);
+        for (const auto & proposal : proposals) {
+            for (const auto & utxo : voteUtxos) {
+                gov::Vote vote(proposal.getHash(), i % 2 == 0 ? gov::NO : gov::YES, utxo, vinHash,
+                               key.GetPubKey().GetID(), 50 * COIN);
+                bool signedVote = vote.sign(key);
+                assert(signedVote);
+                CDataStream ss(SER_NETWORK, GOV_PROTOCOL_VERSION);
+                ss << vote;
+                tx.vout.emplace_back(0, GovernanceScript(ss));
+            }
+        }
+        feeAmount -= COIN / 100;
+        tx.vout.emplace_back(feeAmount, SCRIPT_PUB);
+        fee = COutPoint(tx.GetHash(), tx.vout.size() - 1);
+        MineBlock(SCRIPT_PUB, {tx});
+    }
+}
+
+// Measures the startup replay of governance data from block files
+static void GovernanceLoad(benchmark::State& state, const int nthreads)
+{
+    SelectParams(CBaseChainParams::REGTEST);
+    InitScriptExecutionCache();
+
+    boost::thread_group thread_group;
+    CScheduler scheduler;
+    const CChainParams& chainparams = Params();
+    // Regtest coinbases are worth 50, allow them to vote
+    auto & consensus = const_cast<Consensus::Params&>(chainparams.GetConsensus());
+    const auto voteMinUtxoAmount = consensus.voteMinUtxoAmount;
+    const auto voteBalance = consensus.voteBalance;
+    consensus.voteMinUtxoAmount = 50 * COIN;
+    consensus.voteBalance = 50 * COIN;
+    {
+        LOCK(cs_main);
+        ::pblocktree.reset(new CBlockTreeDB(1 << 20, true));
+        ::pcoinsdbview.reset(new CCoinsViewDB(1 << 23, true));
+        ::pcoinsTip.reset(new CCoinsViewCache(pcoinsdbview.get()));
+    }
+    {
+        thread_group.create_thread(std::bind(&CScheduler::serviceQueue, &scheduler));
+        GetMainSignals().RegisterBackgroundSignalScheduler(scheduler);
+        LoadGenesisBlock(chainparams);
+        CValidationState cvstate;
+        ActivateBestChain(cvstate, chainparams);
+        assert(::chainActive.Tip() != nullptr);
+    }
+
+    if (::chainActive.Height() == 0) // Blocknet uses Quark hash, the chain is shared by both benchmarks
+        CreateGovernanceChain(consensus);
+
+    // Votes are validated against their utxo transactions
+    g_txindex = MakeUnique<TxIndex>(1 << 20, true);
+    g_txindex->Start();
+    g_txindex->Sync();
+
+    auto & governance = gov::Governance::instance();
+    while (state.KeepRunning()) {
+        governance.reset();
+        std::string failReason;
+        bool loaded = governance.loadGovernanceData(::chainActive, cs_main, consensus, failReason, nthreads);
+        assert(loaded);
+        assert(governance.getProposals().size() == NUM_PROPOSALS);
+        assert(governance.getVotes().size() == NUM_PROPOSALS * NUM_VOTE_UTXOS);
+    }
+    governance.reset();
+
+    g_txindex->Stop();
+    g_txindex.reset();
+    thread_group.interrupt_all();
+    thread_group.join_all();
+    GetMainSignals().FlushBackgroundCallbacks();
+    GetMainSignals().UnregisterBackgroundSignalScheduler();
+    consensus.voteMinUtxoAmount = voteMinUtxoAmount;
+    consensus.voteBalance = voteBalance;
+}
+
+static void GovernanceLoadSingleThread(benchmark::State& state)
+{
+    GovernanceLoad(state, 1);
+}
+
+static void GovernanceLoadMultiThread(benchmark::State& state)
+{
+    GovernanceLoad(state, 0);
+}
+
+BENCHMARK(GovernanceLoadSingleThread, 2);
+BENCHMARK(GovernanceLoadMultiThread, 2);
@@ -0,0 +1,63 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <key.h>
+#include <servicenode/servicenodemgr.h>
+
+#include <vector>
+
+static const int NUM_PINGS{200};
+
+// Signed SNLISTPING style packets from distinct snodes
+static std::vector<CDataStream> CreatePings()
+{
+    std::vector<CDataStream> pings;
+    for (int i = 0; i < NUM_PINGS; ++i) {
+        CKey key; key.MakeNewKey(true);
+        sn::ServiceNode snode(key.GetPubKey(), sn::ServiceNode::SPV, key.GetPubKey().GetID(),
+                              {COutPoint(uint256S("0x1"), i)}, 1, uint256S("0x1"), std::vector<unsigned char>());
+        sn::ServiceNodePing ping(key.GetPubKey(), 1, uint256S("0x1"), 1,
+                R"({"xbridgeversion":50,"xrouterversion":50,"xrouter":{"config":"[Main]\nwallets=\nplugins=CustomPlugin1\nhost=127.0.0.1", "plugins":{"CustomPlugin1":""}}})", snode);
+        ping.sign(key);
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        ss << ping;
+        pings.push_back(ss);
+    }
+    return pings;
+}
+
+// Measures the message handler cost of a full servicenode list dump. With
+// verification threads the handler only deserializes and queues each ping,
+// the wait afterwards covers verification on the worker threads.
+static void ServiceNodePings(benchmark::State& state, const int nthreads)
+{
+    SelectParams(CBaseChainParams::REGTEST);
+    ECCVerifyHandle verifyHandle;
+    const auto pings = CreatePings();
+
+    sn::ServiceNodeMgr smgr;
+    smgr.startVerifyThreads(nthreads);
+    while (state.KeepRunning()) {
+        smgr.reset();
+        for (auto ss : pings) {
+            if (nthreads > 0) {
+                smgr.queuePing(ss, nullptr, true);
+            } else {
+                sn::ServiceNodePing ping;
+                smgr.processPing(ss, ping, true);
+            }
+        }
+        smgr.waitForVerifyQueue();
+        assert(smgr.list().size() == NUM_PINGS);
+    }
+    smgr.stopVerifyThreads();
+}
+
+static void ServiceNodePingsInline(benchmark::State& state) { ServiceNodePings(state, 0); }
+static void ServiceNodePingsQueued(benchmark::State& state) { ServiceNodePings(state, 2); }
+
+BENCHMARK(ServiceNodePingsInline, 10);
+BENCHMARK(ServiceNodePingsQueued, 10);
@@ -0,0 +1,68 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <amount.h>
+#include <chainparams.h>
+#include <kernel.h>
+#include <streams.h>
+#include <uint256.h>
+
+#include <cassert>
+
+/* Number of candidate timestamps searched per coin */
+static const int64_t STAKE_WINDOW = 1000;
+static const uint64_t STAKE_MODIFIER = 0x5f1e2d3c4b5a6978;
+static const unsigned int STAKE_BLOCKTIME = 1590000000;
+static const int STAKE_HEIGHT = 1500000;
+static const CAmount STAKE_AMOUNT = 1000 * COIN;
+
+static uint256 StakeBlockHash() {
+    return uint256S("8c0ebbcfa6a7cac3f49da46cbc1e3bf4a8d1ab90d48c6e5a1e3d0a4f8a3ae1b2");
+}
+
+// Current path: serialize the kernel into a fresh stream per timestamp
+static void StakeKernelSearchStream(benchmark::State& state)
+{
+    const auto consensus = CreateChainParams(CBaseChainParams::MAIN)->GetConsensus();
+    const auto blockHash = StakeBlockHash();
+    const int64_t fromTime = consensus.stakingV07UpgradeTime + 1000;
+    arith_uint256 bnTargetPerCoinDay;
+    bnTargetPerCoinDay.SetCompact(0x1800ffff);
+    CDataStream ss(SER_GETHASH, 0);
+    ss << STAKE_MODIFIER;
+    while (state.KeepRunning()) {
+        for (int64_t i = fromTime; i < fromTime + STAKE_WINDOW; ++i) {
+            const auto hashProofOfStake = stakeHashV06(ss, blockHash, STAKE_BLOCKTIME, STAKE_HEIGHT, 1, i);
+            if (stakeTargetHitV07(hashProofOfStake, i, fromTime - 60, STAKE_AMOUNT, bnTargetPerCoinDay, consensus.nPowTargetSpacing))
+                break;
+        }
+    }
+}
+
+// Kernel search engine: precomputed prefix midstate and in place target comparison
+static void StakeKernelSearchMidstate(benchmark::State& state)
+{
+    const auto consensus = CreateChainParams(CBaseChainParams::MAIN)->GetConsensus();
+    const auto blockHash = StakeBlockHash();
+    const int64_t fromTime = consensus.stakingV07UpgradeTime + 1000;
+    arith_uint256 bnTargetPerCoinDay;
+    bnTargetPerCoinDay.SetCompact(0x1800ffff);
+    const auto hasher = StakeKernelHasher::V06(STAKE_MODIFIER, blockHash, STAKE_BLOCKTIME, STAKE_HEIGHT, 1);
+
+    // Engine must produce the same kernel hashes as the stream based path
+    CDataStream ss(SER_GETHASH, 0);
+    ss << STAKE_MODIFIER;
+    assert(hasher.Hash(fromTime) == stakeHashV06(ss, blockHash, STAKE_BLOCKTIME, STAKE_HEIGHT, 1, fromTime));
+
+    int64_t stakeTime{0};
+    uint256 hashProofOfStake;
+    while (state.KeepRunning()) {
+        StakeKernelTarget target(fromTime, fromTime - 60, STAKE_AMOUNT, bnTargetPerCoinDay, consensus);
+        FindStakeKernel(hasher, target, fromTime, fromTime + STAKE_WINDOW, 0, stakeTime, hashProofOfStake);
+    }
+}
+
+BENCHMARK(StakeKernelSearchStream, 500);
+BENCHMARK(StakeKernelSearchMidstate, 500);
@@ -8,8 +8,10 @@
 #include <key_io.h>
 #include <logging.h>
 #include <script/standard.h>
+#include <util/strencodings.h>
 #include <util/system.h>
 
+#include <algorithm>
 #include <fstream>
 
 /**
@@ -24,16 +26,16 @@ const int CoinValidator::CHAIN_HEIGHT = 101651;
  */
 bool CoinValidator::IsCoinValid(const uint256 &txId) const {
     // A coin is valid if its tx is not in the infractions list
-    boost::mutex::scoped_lock l(lock);
-    return infMap.count(txId.ToString()) == 0;
+    const auto *txids = infTxids.load(std::memory_order_acquire);
+    return !txids || !std::binary_search(txids->begin(), txids->end(), txId);
 }
 bool CoinValidator::IsCoinValid(uint256 &txId) const {
-    boost::mutex::scoped_lock l(lock);
-    return infMap.count(txId.ToString()) == 0;
+    return IsCoinValid(static_cast<const uint256&>(txId));
 }
 bool CoinValidator::IsCoinValid(const std::string &txId) const {
-    boost::mutex::scoped_lock l(lock);
-    return infMap.count(txId) == 0;
+    if (txId.size() != 64 || !IsHex(txId))
+        return true; // not a txid, can't be an infraction
+    return IsCoinValid(uint256S(txId));
 }
 
 /**
@@ -121,6 +123,7 @@ bool CoinValidator::IsLoaded() const {
 void CoinValidator::Clear() {
     boost::mutex::scoped_lock l(lock);
     infMap.clear();
+    publishTxids();
     lastLoadH = 0;
     infMapLoaded = false;
     downloadErr = false;
@@ -132,11 +135,13 @@ void CoinValidator::Clear() {
  */
 std::vector<InfractionData> CoinValidator::GetInfractions(const uint256 &txId) {
     boost::mutex::scoped_lock l(lock);
-    return infMap[txId.ToString()];
+    auto it = infMap.find(txId.ToString());
+    if (it == infMap.end())
+        return {};
+    return it->second;
 }
 std::vector<InfractionData> CoinValidator::GetInfractions(uint256 &txId) {
-    boost::mutex::scoped_lock l(lock);
-    return infMap[txId.ToString()];
+    return GetInfractions(static_cast<const uint256&>(txId));
 }
 std::vector<InfractionData> CoinValidator::GetInfractions(const std::string &address) {
     boost::mutex::scoped_lock l(lock);
@@ -203,6 +208,7 @@ bool CoinValidator::Load(int loadHeight) {
 
                     // If we didn't fail return, otherwise proceed to load from network
                     if (!failed) {
+                        publishTxids();
                         LogPrintf("Coin Validator: Loading from cache: %u\n", lastLoadH);
                         return true;
                     }
@@ -220,6 +226,7 @@ bool CoinValidator::Load(int loadHeight) {
     if (!downloadList(lst, err) || lst.empty()) {
         LogPrintf("Coin Validator: Failed to load from network: %s\n", err);
         infMapLoaded = false;
+        publishTxids();
         return false;
     }
 
@@ -227,6 +234,7 @@ bool CoinValidator::Load(int loadHeight) {
     for (std::string &line : lst) {
         addLine(line, infMap);
     }
+    publishTxids();
 
     // Save to disk
     std::ofstream file(getExplPath().string(), std::ios::out | std::ofstream::binary);
@@ -270,11 +278,28 @@ bool CoinValidator::LoadStatic() {
         }
     }
 
+    publishTxids();
+
     lastLoadH = CHAIN_HEIGHT;
     LogPrintf("Coin Validator: Ready: %u\n", lastLoadH);
     return true;
 }
 
+/**
+ * Rebuilds the sorted txid snapshot from the infraction map and publishes it for
+ * lock-free lookups. Must be called with the lock held after infMap changes.
+ */
+void CoinValidator::publishTxids() {
+    std::unique_ptr<std::vector<uint256>> txids(new std::vector<uint256>);
+    txids->reserve(infMap.size());
+    for (const auto &item : infMap)
+        txids->push_back(uint256S(item.first));
+    std::sort(txids->begin(), txids->end());
+    txids->erase(std::unique(txids->begin(), txids->end()), txids->end());
+    infTxids.store(txids.get(), std::memory_order_release);
+    infTxidsRetired.emplace_back(std::move(txids));
+}
+
 /**
  * Return cached file path.
  * @return
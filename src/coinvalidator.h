@@ -11,6 +11,10 @@
 #include <script/script.h>
 #include <uint256.h>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <boost/thread/mutex.hpp>
 #include <boost/filesystem/path.hpp>
 
@@ -66,6 +70,11 @@ private:
     int lastLoadH = 0;
     bool downloadErr = false;
     mutable boost::mutex lock;
+    // Sorted infraction txids, immutable once published. Lookups read the current
+    // snapshot without locking, replaced snapshots are retained for concurrent readers.
+    std::atomic<const std::vector<uint256>*> infTxids{nullptr};
+    std::vector<std::unique_ptr<const std::vector<uint256>>> infTxidsRetired;
+    void publishTxids();
     boost::filesystem::path getExplPath();
     bool addLine(std::string &line, std::map<std::string, std::vector<InfractionData>> &map);
     int getBlockHeight(std::string &line);
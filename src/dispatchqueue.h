@@ -0,0 +1,184 @@
+// Copyright (c) 2019 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BLOCKNET_DISPATCHQUEUE_H
+#define BLOCKNET_DISPATCHQUEUE_H
+
+#include <logging.h>
+#include <net.h>
+#include <sync.h>
+#include <util/system.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Bounded work queue used to move subsystem packet processing off the
+ * net message handler thread. Work is queued per peer and workers pick
+ * peers round-robin, so a single chatty peer can't starve the others.
+ * push() refuses work once the queue (or the peer's share of it) is
+ * full, callers are expected to drop the packet in that case.
+ *
+ * With a single worker thread work from each peer runs in the order it
+ * was pushed. If no worker threads are started work runs inline. The pool
+ * can grow on demand, a worker is added when work is pushed while every
+ * worker is busy.
+ */
+class PeerDispatchQueue {
+public:
+    typedef std::function<void()> Work;
+
+    PeerDispatchQueue(const std::string & name, const size_t maxItems, const size_t maxPerPeer)
+        : name(name), maxItems(maxItems), maxPerPeer(maxPerPeer) {}
+
+    ~PeerDispatchQueue() {
+        stop();
+    }
+
+    /**
+     * Starts the specified number of worker threads.
+     * @param threads
+     * @param maxThreads If larger than threads the pool grows up to this many
+     *                   workers when all workers are busy, it doesn't shrink.
+     */
+    void start(const int threads, const int maxThreads = 0) {
+        LOCK(mu);
+        if (!workers.empty())
+            return;
+        stopped = false;
+        this->maxThreads = static_cast<size_t>(std::max(threads, maxThreads));
+        for (int i = 0; i < threads; ++i)
+            addWorker();
+    }
+
+    /**
+     * Stops the worker threads, queued work that hasn't started is discarded.
+     */
+    void stop() {
+        std::vector<std::thread> threads;
+        {
+            LOCK(mu);
+            stopped = true;
+            threads.swap(workers);
+            queues.clear();
+            ready.clear();
+            queued = 0;
+        }
+        cond.notify_all();
+        for (auto & t : threads) {
+            if (t.joinable())
+                t.join();
+        }
+    }
+
+    /**
+     * Queues work on behalf of the peer. Returns false if the work was
+     * rejected because the queue is full or stopped.
+     * @param peer
+     * @param work
+     * @return
+     */
+    bool push(const NodeId peer, Work work) {
+        {
+            LOCK(mu);
+            if (stopped)
+                return false;
+            if (!workers.empty()) {
+                if (queued >= maxItems)
+                    return false;
+                auto & q = queues[peer];
+                if (q.size() >= maxPerPeer)
+                    return false;
+                if (q.empty())
+                    ready.push_back(peer);
+                q.push_back(std::move(work));
+                ++queued;
+                if (busy + queued > workers.size() && workers.size() < maxThreads)
+                    addWorker();
+                cond.notify_one();
+                return true;
+            }
+        }
+        execute(work);
+        return true;
+    }
+
+    /**
+     * Returns the number of queued items that haven't started.
+     * @return
+     */
+    size_t size() {
+        LOCK(mu);
+        return queued;
+    }
+
+private:
+    void addWorker() EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        workers.emplace_back([this]() {
+            RenameThread(("blocknet-" + name).c_str());
+            run();
+        });
+    }
+
+    void run() {
+        while (true) {
+            Work work;
+            {
+                WAIT_LOCK(mu, lock);
+                cond.wait(lock, [this]() { return stopped || !ready.empty(); });
+                if (stopped)
+                    return;
+                // Take one item from the next peer in line, a peer with
+                // more work goes to the back of the line.
+                const NodeId peer = ready.front();
+                ready.pop_front();
+                auto it = queues.find(peer);
+                work = std::move(it->second.front());
+                it->second.pop_front();
+                if (it->second.empty())
+                    queues.erase(it);
+                else
+                    ready.push_back(peer);
+                --queued;
+                ++busy;
+            }
+            execute(work);
+            LOCK(mu);
+            --busy;
+        }
+    }
+
+    void execute(const Work & work) {
+        try {
+            work();
+        } catch (std::exception & e) {
+            LogPrintf("%s dispatch error: %s\n", name, e.what());
+        } catch (...) {
+            LogPrintf("%s dispatch error: unknown exception\n", name);
+        }
+    }
+
+private:
+    const std::string name;
+    const size_t maxItems;
+    const size_t maxPerPeer;
+
+    Mutex mu;
+    std::condition_variable cond;
+    std::vector<std::thread> workers GUARDED_BY(mu);
+    std::map<NodeId, std::deque<Work>> queues GUARDED_BY(mu);
+    std::deque<NodeId> ready GUARDED_BY(mu);
+    size_t queued GUARDED_BY(mu){0};
+    size_t busy GUARDED_BY(mu){0}; // workers running work
+    size_t maxThreads GUARDED_BY(mu){0};
+    bool stopped GUARDED_BY(mu){false};
+};
+
+#endif // BLOCKNET_DISPATCHQUEUE_H
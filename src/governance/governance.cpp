@@ -62,6 +62,10 @@ GovernanceDB::GovernanceDB(size_t n_cache_size, bool f_memory, bool f_wipe)
 
 void GovernanceDB::Reset(const bool wipe=false) {
     bestBlockIndex = nullptr;
+    {
+        LOCK(mu);
+        batch.reset();
+    }
     db.reset();
     db = MakeUnique<GovernanceDB::DB>(cache, memory, wipe);
 }
@@ -92,7 +96,7 @@ bool GovernanceDB::WriteBestBlock(const CBlockIndex *pindex, const CChain & chai
 }
 
 void GovernanceDB::AddVote(const CDiskVote & vote) {
-    db->WriteVote(vote.getHash(), vote);
+    write(std::make_pair(DB_VOTE, vote.getHash()), vote);
 }
 
 bool GovernanceDB::AddVotes(const std::vector<std::pair<uint256, CDiskVote>> & votes) {
@@ -100,11 +104,11 @@ bool GovernanceDB::AddVotes(const std::vector<std::pair<uint256, CDiskVote>> & v
 }
 
 void GovernanceDB::RemoveVote(const uint256 & vote) {
-    db->Erase(vote);
+    erase(std::make_pair(DB_VOTE, vote));
 }
 
 void GovernanceDB::AddProposal(const CDiskProposal & proposal) {
-    db->WriteProposal(proposal.getHash(), proposal);
+    write(std::make_pair(DB_PROPOSAL, proposal.getHash()), proposal);
 }
 
 bool GovernanceDB::AddProposals(const std::vector<std::pair<uint256, CDiskProposal>> & proposals) {
@@ -112,7 +116,7 @@ bool GovernanceDB::AddProposals(const std::vector<std::pair<uint256, CDiskPropos
 }
 
 void GovernanceDB::RemoveProposal(const uint256 & proposal) {
-    db->Erase(proposal);
+    erase(std::make_pair(DB_PROPOSAL, proposal));
 }
 
 bool GovernanceDB::ReadSpentUtxo(const std::string & key, CDiskSpentUtxo & utxo) {
@@ -127,18 +131,37 @@ bool GovernanceDB::RemoveSpentUtxo(const CDiskSpentUtxo & utxo, const bool sync)
     return db->Erase(std::make_pair(DB_SPENT_UTXO, utxo.Key()), sync);
 }
 
+void GovernanceDB::BeginBatch() {
+    LOCK(mu);
+    if (!batch)
+        batch = MakeUnique<CDBBatch>(*db);
+}
+
+bool GovernanceDB::CommitBatch(const bool sync) {
+    std::unique_ptr<CDBBatch> pending;
+    {
+        LOCK(mu);
+        pending = std::move(batch);
+    }
+    if (!pending || pending->SizeEstimate() == 0)
+        return true;
+    return db->WriteBatch(*pending, sync);
+}
+
 void GovernanceDB::BlockConnected(const std::shared_ptr<const CBlock> & block, const CBlockIndex *pindex,
                                   const std::vector<CTransactionRef> & txn_conflicted)
 {
-    std::vector<std::pair<std::string, CDiskSpentUtxo>> spentUtxos;
+    // Spent utxos are committed with any governance data from the block in a
+    // single write, fsync is left to ChainStateFlushed.
+    BeginBatch();
     for (const auto & tx : block->vtx) {
         for (const auto & vin : tx->vin) {
             CDiskSpentUtxo utxo(vin.prevout, pindex->nHeight, tx->GetHash());
-            spentUtxos.emplace_back(utxo.Key(), utxo);
+            write(std::make_pair(DB_SPENT_UTXO, utxo.Key()), utxo);
         }
     }
-    if (!spentUtxos.empty())
-        db->WriteSpentUtxos(spentUtxos, !IsInitialBlockDownload());
+    if (!CommitBatch())
+        error("%s: Failed to write governance data for block %s", __func__, pindex->GetBlockHash().ToString());
 
     auto blockIndex = bestBlockIndex.load();
     if (!blockIndex) {
@@ -158,12 +181,15 @@ void GovernanceDB::BlockConnected(const std::shared_ptr<const CBlock> & block, c
 }
 
 void GovernanceDB::BlockDisconnected(const std::shared_ptr<const CBlock> & block) {
+    BeginBatch();
     for (const auto & tx : block->vtx) {
         for (const auto & vin : tx->vin) {
             CDiskSpentUtxo utxo(vin.prevout, 0, uint256{});
-            RemoveSpentUtxo(utxo, !IsInitialBlockDownload());
+            erase(std::make_pair(DB_SPENT_UTXO, utxo.Key()));
         }
     }
+    if (!CommitBatch())
+        error("%s: Failed to remove governance data for block %s", __func__, block->GetHash().ToString());
 }
 
 void GovernanceDB::ChainStateFlushed(const CBlockLocator & locator) {
@@ -188,6 +214,9 @@ void GovernanceDB::ChainStateFlushed(const CBlockLocator & locator) {
         return;
     }
 
+    // Sync all prior governance writes before the locator is advanced
+    if (!CommitBatch(true) || !db->Sync())
+        error("%s: Failed to flush governance data to disk", __func__);
     if (!db->WriteBestBlock(locator))
         error("%s: Failed to write locator to disk", __func__);
 }
@@ -27,6 +27,7 @@
 
 #include <regex>
 #include <string>
+#include <unordered_set>
 #include <utility>
 
 #include <boost/algorithm/string.hpp>
@@ -68,6 +69,12 @@ public:
     bool AddSpentUtxos(const std::vector<std::pair<std::string, CDiskSpentUtxo>> & utxos, bool sync=false);
     bool RemoveSpentUtxo(const CDiskSpentUtxo & utxo, bool sync=false);
 
+    /// Queue writes in a single batch until CommitBatch is called. Writes made outside
+    /// of a batch go directly to the db.
+    void BeginBatch();
+    /// Write the pending batch to the db. Sync is deferred to ChainStateFlushed.
+    bool CommitBatch(bool sync=false);
+
     class DB : public CDBWrapper {
     public:
         explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
@@ -111,8 +118,28 @@ protected:
     /// The last block in the chain that the index is in sync with.
     std::atomic<const CBlockIndex*> bestBlockIndex{nullptr};
 
+private:
+    template <typename K, typename V>
+    void write(const K & key, const V & value) {
+        LOCK(mu);
+        if (batch)
+            batch->Write(key, value);
+        else
+            db->Write(key, value);
+    }
+    template <typename K>
+    void erase(const K & key) {
+        LOCK(mu);
+        if (batch)
+            batch->Erase(key);
+        else
+            db->Erase(key);
+    }
+
 private:
     std::unique_ptr<DB> db;
+    Mutex mu;
+    std::unique_ptr<CDBBatch> batch GUARDED_BY(mu); // pending writes for the block being connected or disconnected
 };
 
 /**
@@ -1124,6 +1151,11 @@ public:
         votes.clear();
         stackvotes.clear();
         sbvotes.clear();
+        sbutxos.clear();
+        sbamounts.clear();
+        pvotes.clear();
+        ptallies.clear();
+        sbresults.clear();
         db->Reset(true);
         return true;
     }
@@ -1195,16 +1227,27 @@ public:
         const auto cores = nthreads == 0 ? GetNumCores() : nthreads;
         std::unordered_map<COutPoint, CDiskSpentUtxo, Hasher> spentPrevouts;
         bool useThreadGroup{false};
-
-        // Shard the blocks into num equivalent to available cores
-        const int totalBlocks = blockHeight - bestBlockHeight;
-        int slice = totalBlocks / cores;
         bool failed{false};
 
-        auto p1 = [&spentPrevouts,&failed,&failReasonRet,&chain,&chainMutex,&mut,this]
+        // Blocks are loaded in two phases. In the first phase worker threads read
+        // blocks from disk and extract the governance data and spent prevouts into
+        // per-block buffers. This doesn't depend on governance state, filtering
+        // outside of chain tip processing only validates the data against the chain.
+        // In the second phase the buffers are applied in block order on this thread,
+        // which results in the same state as processing the blocks serially. Blocks
+        // are loaded in batches to bound memory usage.
+        struct BlockData {
+            std::set<Proposal> proposals;
+            std::set<Vote> votes;
+            std::vector<CDiskSpentUtxo> spent;
+        };
+        std::vector<BlockData> batch;
+        std::atomic<int> next{0};
+
+        auto p1 = [&batch,&next,&failed,&failReasonRet,&chain,&chainMutex,&mut,this]
                   (const int start, const int end, const Consensus::Params & consensus) -> bool
         {
-            for (int blockNumber = start; blockNumber < end; ++blockNumber) {
+            for (int blockNumber = start + next++; blockNumber < end; blockNumber = start + next++) {
                 if (ShutdownRequested()) { // don't hold up shutdown requests
                     LOCK(mut);
                     failed = true;
@@ -1230,51 +1273,72 @@ public:
                     failReasonRet += strprintf("Failed to read block from disk for block %d\n", blockNumber);
                     return false;
                 }
+                auto & data = batch[blockNumber - start];
                 // Store all vins in order to use as a lookup for spent votes
                 for (const auto & tx : block.vtx) {
-                    LOCK(mut);
                     const auto & txhash = tx->GetHash();
                     for (const auto & vin : tx->vin)
-                        spentPrevouts[vin.prevout] = CDiskSpentUtxo{vin.prevout, static_cast<uint32_t>(blockIndex->nHeight), txhash};
+                        data.spent.push_back(CDiskSpentUtxo{vin.prevout, static_cast<uint32_t>(blockIndex->nHeight), txhash});
                 }
-                // Process block
-                processBlock(&block, blockIndex->nHeight, consensus, false);
+                std::map<uint256,std::set<VinHash>> vh;
+                dataFromBlock(&block, data.proposals, data.votes, vh, consensus, blockIndex->nHeight);
+                filterDataFromBlock(data.proposals, data.votes, vh, consensus, blockIndex->nHeight, false);
             }
             return true;
         };
 
-        for (int k = 0; k < cores; ++k) {
-            const int start = bestBlockHeight + k*slice;
-            const int end = k == cores-1 ? blockHeight+1 // check bounds, +1 due to "<" logic below, ensure inclusion of last block
-                                         : start+slice;
-            // try single threaded on failure
-            try {
-                // TODO Blocknet governance: concurrency causing state issues
-//                if (cores > 1) {
-//                    tg.create_thread([start,end,consensus,&p1] {
-//                        RenameThread("blocknet-governance");
-//                        p1(start, end, consensus);
-//                    });
-//                    useThreadGroup = true;
-//                } else
-                    p1(start, end, consensus);
-            } catch (...) {
+        const int batchBlocks = cores * 500;
+        for (int start = bestBlockHeight; start <= blockHeight; start += batchBlocks) {
+            const int end = std::min(start + batchBlocks, blockHeight+1); // +1 to include the last block
+            batch.clear();
+            batch.resize(end - start);
+            next = 0;
+            useThreadGroup = false;
+
+            // Phase one: extract block data, this thread is also a worker
+            boost::thread_group workers;
+            for (int k = 1; k < cores; ++k) {
                 try {
-                    p1(start, end, consensus);
-                } catch (std::exception & e) {
-                    failed = true;
-                    failReasonRet += strprintf("Failed to create thread to load governance data: %s\n", e.what());
-                    return false; // fatal error
+                    workers.create_thread([start,end,consensus,&p1,&failed,&failReasonRet,&mut] {
+                        RenameThread("blocknet-governance");
+                        try {
+                            p1(start, end, consensus);
+                        } catch (std::exception & e) {
+                            LOCK(mut);
+                            failed = true;
+                            failReasonRet += strprintf("Failed to load governance data: %s\n", e.what());
+                        }
+                    });
+                    useThreadGroup = true;
+                } catch (...) {
+                    break; // remaining blocks are picked up by the other workers
                 }
             }
-        }
+            try {
+                p1(start, end, consensus);
+            } catch (std::exception & e) {
+                LOCK(mut);
+                failed = true;
+                failReasonRet += strprintf("Failed to load governance data: %s\n", e.what());
+            }
+            // Wait for all threads to complete
+            if (useThreadGroup)
+                workers.join_all();
 
-        // Wait for all threads to complete
-        if (useThreadGroup)
-            tg.join_all();
+            if (failed)
+                return false;
 
-        if (failed)
-            return false;
+            // Phase two: apply the block data in order
+            LOCK(mu);
+            for (const auto & data : batch) {
+                for (const auto & p : data.proposals)
+                    addProposal(p, false);
+                for (const auto & v : data.votes)
+                    addVote(v, false);
+                for (const auto & spent : data.spent)
+                    spentPrevouts[spent.outpoint] = spent;
+            }
+        }
 
         bool haveVotes{false};
         {
@@ -1367,7 +1431,7 @@ public:
 
             useThreadGroup = false; // initial state
 
-            slice = static_cast<int>(tmpvotes.size()) / cores;
+            const int slice = static_cast<int>(tmpvotes.size()) / cores;
             for (int k = 0; k < cores; ++k) {
                 const int start = k*slice;
                 const int end = k == cores-1 ? static_cast<int>(tmpvotes.size())
@@ -1548,20 +1612,7 @@ public:
      */
     std::vector<Vote> getVotes(const uint256 & proposalHash, const bool & returnSpent = false) {
         LOCK(mu);
-        std::vector<Vote> vos;
-        if (!proposals.count(proposalHash))
-            return vos;
-
-        const auto & proposal = proposals[proposalHash];
-        if (!sbvotes.count(proposal.getSuperblock()))
-            return vos;
-
-        auto & vs = sbvotes[proposal.getSuperblock()];
-        for (auto & item : vs) {
-            if (item.second.getProposal() == proposalHash && (returnSpent || !item.second.spent()))
-                vos.push_back(item.second);
-        }
-        return vos;
+        return proposalVotes(proposalHash, returnSpent);
     }
 
     /**
@@ -1611,7 +1662,9 @@ public:
             auto & mv = sbvotes[proposals[vote.getProposal()].getSuperblock()];
             if (mv.count(voteHash)) {
                 auto & v = mv[voteHash];
+                unindexVote(proposals[vote.getProposal()].getSuperblock(), v);
                 v.spend(block, txhash);
+                indexVote(proposals[vote.getProposal()].getSuperblock(), v);
             }
         }
         stackvotes[voteHash].back().spend(block, txhash);
@@ -1648,7 +1701,9 @@ public:
             auto & mv = sbvotes[proposals[vote.getProposal()].getSuperblock()];
             if (mv.count(voteHash)) {
                 auto & v = mv[voteHash];
+                unindexVote(proposals[vote.getProposal()].getSuperblock(), v);
                 v.unspend(block, txhash);
+                indexVote(proposals[vote.getProposal()].getSuperblock(), v);
             }
         }
         stackvotes[voteHash].back().unspend(block, txhash);
@@ -1825,45 +1880,16 @@ public:
         if (!isSuperblock(superblock, params))
             return r;
 
-        std::set<COutPoint> unique;
-        std::vector<Proposal> ps;
-        std::vector<Vote> vs;
-        getProposalsForSuperblock(superblock, ps, vs);
-
-        CAmount uniqueAmount{0};
-        for (const auto & vote : vs) { // count all the unique voting utxos
-            if (unique.count(vote.getUtxo()))
-                continue;
-            unique.insert(vote.getUtxo());
-            uniqueAmount += vote.getAmount();
-        }
-        const auto uniqueVotes = static_cast<int>(uniqueAmount / params.voteBalance);
-
-        for (const auto & proposal : ps) // get results for each proposal
-            r[proposal] = getTally(proposal.getHash(), vs, params);
-
-        // a) Exclude proposals that don't have the required yes votes.
-        //    60% of votes must be "yes" on a passing proposal.
-        // b) Exclude proposals that don't have at least 25% of all participating
-        //    votes. i.e. at least 25% of all votes cast this superblock must have
-        //    voted on this proposal.
-        // c) Exclude proposals with 0 yes votes in all circumstances
-        for (auto it = r.begin(); it != r.end(); ) {
-            const auto & tally = it->second;
-            const int total = tally.yes+tally.no+tally.abstain;
-            const int yaynay = tally.yes + tally.no;
-            if ((yaynay == 0 || static_cast<double>(tally.yes) / static_cast<double>(yaynay) < 0.6
-              || static_cast<double>(total) < static_cast<double>(uniqueVotes) * 0.25
-              || tally.yes <= 0)) {
-                if (!includeExcluded) {
-                    r.erase(it++);
-                    continue;
-                }
-            } else
-                it->second.payout = true;
-            ++it;
+        LOCK(mu);
+        auto cached = sbresults.find(superblock);
+        if (cached == sbresults.end())
+            cached = sbresults.emplace(superblock, superblockResults(superblock, params)).first;
+        if (includeExcluded)
+            return cached->second;
+        for (const auto & item : cached->second) {
+            if (item.second.payout)
+                r.insert(item);
         }
-
         return r;
     }
 
@@ -1961,16 +1987,9 @@ public:
             return false; // if tip isn't in the non-voting period then return
 
         // Check if the utxo is in a valid proposal who's voting period has ended
-        std::vector<Proposal> sproposals;
-        std::vector<Vote> svotes;
-        getProposalsForSuperblock(superblock, sproposals, svotes);
-
-        for (const auto & vote : svotes) {
-            if (utxo == vote.getUtxo())
-                return true;
-        }
-
-        return false;
+        LOCK(mu);
+        const auto it = sbutxos.find(superblock);
+        return it != sbutxos.end() && it->second.count(utxo) > 0;
     }
 
     /**
@@ -1981,13 +2000,10 @@ public:
      * @return
      */
     bool utxoInVote(const COutPoint & utxo, const int & blockHeight, const Consensus::Params & params) {
-        const auto sproposals = getProposalsSince(blockHeight);
-        for (const auto & proposal : sproposals) {
-            const auto svotes = getVotes(proposal.getHash());
-            for (const auto & vote : svotes) {
-                if (utxo == vote.getUtxo())
-                    return true;
-            }
+        LOCK(mu);
+        for (auto it = sbutxos.lower_bound(blockHeight); it != sbutxos.end(); ++it) {
+            if (it->second.count(utxo))
+                return true;
         }
         return false;
     }
@@ -2002,12 +2018,11 @@ public:
      */
     void utxosInVotes(const std::set<COutPoint> & utxos, const int & blockHeight, std::set<COutPoint> & utxosRet, const Consensus::Params & params) {
         utxosRet.clear();
-        const auto sproposals = getProposalsSince(blockHeight);
-        for (const auto & proposal : sproposals) {
-            const auto svotes = getVotes(proposal.getHash());
-            for (const auto & vote : svotes) {
-                if (utxos.count(vote.getUtxo()))
-                    utxosRet.insert(vote.getUtxo());
+        LOCK(mu);
+        for (auto it = sbutxos.lower_bound(blockHeight); it != sbutxos.end(); ++it) {
+            for (const auto & utxo : utxos) {
+                if (it->second.count(utxo))
+                    utxosRet.insert(utxo);
             }
         }
     }
@@ -2146,6 +2161,18 @@ public: // static
         return blockNumber >= superblock - params.votingCutoff && blockNumber <= superblock;
     }
 
+    /**
+     * Returns the vote tally for the specified proposal's unspent votes. Tallies are cached
+     * and only recalculated after the proposal's votes change.
+     * @param proposal
+     * @param params
+     * @return
+     */
+    Tally getTally(const uint256 & proposal, const Consensus::Params & params) {
+        LOCK(mu);
+        return proposalTally(proposal, params);
+    }
+
     /**
      * Returns the vote tally for the specified proposal.
      * @param proposal
@@ -2306,6 +2333,7 @@ protected:
         const auto & params = Params().GetConsensus();
         if (pindex->nHeight < params.governanceBlock)
             return;
+        db->BeginBatch(); // proposal and vote writes are committed with the block's spent utxos
         processBlock(block.get(), pindex->nHeight, params);
         db->BlockConnected(block, pindex, txn_conflicted);
     }
@@ -2325,8 +2353,8 @@ protected:
         if (blockHeight < params.governanceBlock)
             return;
 
-        // Update db
-        db->BlockDisconnected(block);
+        // Vote and proposal removals are committed with the block's spent utxos
+        db->BeginBatch();
 
         std::set<Proposal> ps;
         std::set<Vote> vs;
@@ -2384,38 +2412,41 @@ protected:
                 removeProposal(proposal);
         }
 
-        if (blockHeight == maxInt)
-            return; // do not unspend votes if block height is undefined
-
         // Unspend any vote utxos that were spent by this
         // block. Only unspend those votes where the block
         // index that tried to spend them was prior to
-        // the proposal's superblock.
-        std::map<COutPoint, uint256> prevouts; // map<outpoint, txhash>
-        for (const auto & tx : block->vtx) {
-            for (const auto & vin : tx->vin)
-                prevouts[vin.prevout] = tx->GetHash();
-        }
+        // the proposal's superblock. Votes are not unspent
+        // if the block height is undefined.
+        if (blockHeight != maxInt) {
+            std::map<COutPoint, uint256> prevouts; // map<outpoint, txhash>
+            for (const auto & tx : block->vtx) {
+                for (const auto & vin : tx->vin)
+                    prevouts[vin.prevout] = tx->GetHash();
+            }
 
-        // Get a list of all proposals with a superblock that is on or
-        // after the current block index.
-        auto sprops = getProposalsSince(blockHeight);
-        // Obtain all votes for these proposals
-        std::vector<Vote> svotes;
-        for (const auto & p : sprops) {
-            auto s = getVotes(p.getHash(), true);
-            svotes.insert(svotes.end(), s.begin(), s.end());
-        }
-        // Unspend votes that match spent vins
-        if (!svotes.empty()) {
-            LOCK(mu);
-            for (auto & v : svotes) {
-                if (!prevouts.count(v.getUtxo()))
-                    continue;
-                // Unspend this vote if it was spent in this block
-                unspendVote(v.getHash(), blockHeight, prevouts[v.getUtxo()]);
+            // Get a list of all proposals with a superblock that is on or
+            // after the current block index.
+            auto sprops = getProposalsSince(blockHeight);
+            // Obtain all votes for these proposals
+            std::vector<Vote> svotes;
+            for (const auto & p : sprops) {
+                auto s = getVotes(p.getHash(), true);
+                svotes.insert(svotes.end(), s.begin(), s.end());
+            }
+            // Unspend votes that match spent vins
+            if (!svotes.empty()) {
+                LOCK(mu);
+                for (auto & v : svotes) {
+                    if (!prevouts.count(v.getUtxo()))
+                        continue;
+                    // Unspend this vote if it was spent in this block
+                    unspendVote(v.getHash(), blockHeight, prevouts[v.getUtxo()]);
+                }
             }
         }
+
+        // Update db, commits the batch
+        db->BlockDisconnected(block);
     }
 
     /**
@@ -2503,7 +2534,10 @@ protected:
 
         const auto & proposal = proposals[vote.getProposal()];
         auto & vs = sbvotes[proposal.getSuperblock()];
+        if (vs.count(voteHash))
+            unindexVote(proposal.getSuperblock(), vs[voteHash]);
         vs[voteHash] = vote;
+        indexVote(proposal.getSuperblock(), vote);
 
         if (savedb)
             db->AddVote(CDiskVote(vote));
@@ -2534,9 +2568,13 @@ protected:
             votes.erase(voteHash);
         }
 
-        // Erase from db
-        if (savedb)
-            db->RemoveVote(voteHash);
+        // Erase from db, or restore the prior vote if one is left in the history
+        if (savedb) {
+            if (votes.count(voteHash))
+                db->AddVote(CDiskVote(votes[voteHash]));
+            else
+                db->RemoveVote(voteHash);
+        }
 
         if (!proposals.count(vote.getProposal()))
             return;
@@ -2549,10 +2587,13 @@ protected:
         if (!vs.count(voteHash))
             return;
         // Remove from superblock votes data provider
+        unindexVote(proposal.getSuperblock(), vs[voteHash]);
         if (!stackvotes.count(voteHash))
             vs.erase(voteHash);
-        else
+        else {
             vs[voteHash] = stackvotes[voteHash].back();
+            indexVote(proposal.getSuperblock(), vs[voteHash]);
+        }
     }
 
     /**
@@ -2587,12 +2628,14 @@ protected:
             if (!vs.count(voteHash))
                 return true;
             // Remove from superblock votes data provider
+            unindexVote(proposal.getSuperblock(), vs[voteHash]);
             if (!stackvotes.count(voteHash)) {
                 vs.erase(voteHash);
                 return true;
             }
 
             vs[voteHash] = stackvotes[voteHash].back();
+            indexVote(proposal.getSuperblock(), vs[voteHash]);
             vote = stackvotes[voteHash].back();
         }
 
@@ -2608,6 +2651,8 @@ protected:
         if (proposals.count(proposal.getHash()))
             return; // do not overwrite existing proposals
         proposals[proposal.getHash()] = proposal;
+        ptallies.erase(proposal.getHash());
+        reindexVoteUtxos(proposal.getSuperblock());
         if (savedb)
             db->AddProposal(CDiskProposal(proposal));
     }
@@ -2619,17 +2664,185 @@ protected:
      */
     void removeProposal(const Proposal & proposal, bool savedb=true) EXCLUSIVE_LOCKS_REQUIRED(mu) {
         const auto hash = proposal.getHash();
-        proposals.erase(hash);
+        if (proposals.count(hash)) {
+            const auto superblock = proposals[hash].getSuperblock();
+            proposals.erase(hash);
+            ptallies.erase(hash);
+            reindexVoteUtxos(superblock);
+        }
         if (savedb)
             db->RemoveProposal(hash);
     }
 
+    /**
+     * Adds the vote to the per-proposal vote index and the superblock's vote utxo
+     * index. Must be called after the vote is added to sbvotes.
+     * @param superblock
+     * @param vote
+     */
+    void indexVote(const int & superblock, const Vote & vote) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        pvotes[vote.getProposal()].insert(vote.getHash());
+        ptallies.erase(vote.getProposal());
+        sbresults.erase(superblock);
+        indexVoteUtxo(superblock, vote, true);
+    }
+
+    /**
+     * Removes the vote from the per-proposal vote index and the superblock's vote utxo
+     * index. Must be called before the vote in sbvotes is changed or erased.
+     * @param superblock
+     * @param vote
+     */
+    void unindexVote(const int & superblock, const Vote & vote) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        auto it = pvotes.find(vote.getProposal());
+        if (it != pvotes.end()) {
+            it->second.erase(vote.getHash());
+            if (it->second.empty())
+                pvotes.erase(it);
+        }
+        ptallies.erase(vote.getProposal());
+        sbresults.erase(superblock);
+        indexVoteUtxo(superblock, vote, false);
+    }
+
+    /**
+     * Calculates the results for all the proposals scheduled for the specified superblock,
+     * including proposals that didn't make the superblock (payout is false).
+     * @param superblock
+     * @param params
+     * @return
+     */
+    std::map<Proposal, Tally> superblockResults(const int & superblock, const Consensus::Params & params) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        std::map<Proposal, Tally> r;
+        // Amount of all the unique voting utxos
+        CAmount uniqueAmount{0};
+        auto it = sbamounts.find(superblock);
+        if (it != sbamounts.end())
+            uniqueAmount = it->second;
+        const auto uniqueVotes = static_cast<int>(uniqueAmount / params.voteBalance);
+
+        for (const auto & item : proposals) { // get results for each proposal
+            if (item.second.getSuperblock() == superblock)
+                r[item.second] = proposalTally(item.first, params);
+        }
+
+        // a) Exclude proposals that don't have the required yes votes.
+        //    60% of votes must be "yes" on a passing proposal.
+        // b) Exclude proposals that don't have at least 25% of all participating
+        //    votes. i.e. at least 25% of all votes cast this superblock must have
+        //    voted on this proposal.
+        // c) Exclude proposals with 0 yes votes in all circumstances
+        for (auto & item : r) {
+            auto & tally = item.second;
+            const int total = tally.yes+tally.no+tally.abstain;
+            const int yaynay = tally.yes + tally.no;
+            tally.payout = !(yaynay == 0 || static_cast<double>(tally.yes) / static_cast<double>(yaynay) < 0.6
+                          || static_cast<double>(total) < static_cast<double>(uniqueVotes) * 0.25
+                          || tally.yes <= 0);
+        }
+
+        return r;
+    }
+
+    /**
+     * Returns the cached tally for the specified proposal, calculating it if necessary.
+     * @param proposal
+     * @param params
+     * @return
+     */
+    Tally proposalTally(const uint256 & proposal, const Consensus::Params & params) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        auto it = ptallies.find(proposal);
+        if (it != ptallies.end())
+            return it->second;
+        const auto tally = getTally(proposal, proposalVotes(proposal, false), params);
+        ptallies[proposal] = tally;
+        return tally;
+    }
+
+    /**
+     * Returns the votes for the specified proposal using the per-proposal vote index.
+     * @param proposalHash
+     * @param returnSpent Includes spent votes
+     * @return
+     */
+    std::vector<Vote> proposalVotes(const uint256 & proposalHash, const bool & returnSpent) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        std::vector<Vote> vos;
+        auto pit = proposals.find(proposalHash);
+        auto vit = pvotes.find(proposalHash);
+        if (pit == proposals.end() || vit == pvotes.end())
+            return vos;
+        auto sbit = sbvotes.find(pit->second.getSuperblock());
+        if (sbit == sbvotes.end())
+            return vos;
+        const auto & vs = sbit->second;
+        vos.reserve(vit->second.size());
+        for (const auto & voteHash : vit->second) {
+            auto it = vs.find(voteHash);
+            if (it != vs.end() && (returnSpent || !it->second.spent()))
+                vos.push_back(it->second);
+        }
+        return vos;
+    }
+
+    /**
+     * Adds or removes the vote's utxo in the superblock's vote utxo index. Only unspent
+     * votes associated with a known proposal are indexed. Utxos are ref counted since
+     * the same utxo can vote on multiple proposals in a superblock.
+     * @param superblock
+     * @param vote
+     * @param add Adds the vote if true, otherwise removes it
+     */
+    void indexVoteUtxo(const int & superblock, const Vote & vote, const bool & add) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        if (vote.spent() || !proposals.count(vote.getProposal()))
+            return;
+        if (add) {
+            if (++sbutxos[superblock][vote.getUtxo()] == 1)
+                sbamounts[superblock] += vote.getAmount();
+            return;
+        }
+        auto sbit = sbutxos.find(superblock);
+        if (sbit == sbutxos.end())
+            return;
+        auto & utxos = sbit->second;
+        auto it = utxos.find(vote.getUtxo());
+        if (it == utxos.end())
+            return;
+        if (--it->second <= 0) {
+            utxos.erase(it);
+            sbamounts[superblock] -= vote.getAmount();
+        }
+        if (utxos.empty()) {
+            sbutxos.erase(sbit);
+            sbamounts.erase(superblock);
+        }
+    }
+
+    /**
+     * Rebuilds the vote utxo index for the superblock, required when the superblock's
+     * proposals change. Cached superblock results are dropped.
+     * @param superblock
+     */
+    void reindexVoteUtxos(const int & superblock) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        sbutxos.erase(superblock);
+        sbamounts.erase(superblock);
+        sbresults.erase(superblock);
+        if (!sbvotes.count(superblock))
+            return;
+        for (const auto & item : sbvotes[superblock])
+            indexVoteUtxo(superblock, item.second, true);
+    }
+
 protected:
     Mutex mu;
     std::unordered_map<uint256, Proposal, Hasher> proposals GUARDED_BY(mu);
     std::unordered_map<uint256, Vote, Hasher> votes GUARDED_BY(mu);
     std::unordered_map<uint256, std::vector<Vote>, Hasher> stackvotes GUARDED_BY(mu);
     std::unordered_map<int, std::unordered_map<uint256, Vote, Hasher>> sbvotes GUARDED_BY(mu);
+    std::map<int, std::unordered_map<COutPoint, int, SaltedOutpointHasher>> sbutxos GUARDED_BY(mu); // unspent vote utxos by superblock
+    std::unordered_map<int, CAmount> sbamounts GUARDED_BY(mu); // total amount of the unique unspent vote utxos by superblock
+    std::unordered_map<uint256, std::unordered_set<uint256, Hasher>, Hasher> pvotes GUARDED_BY(mu); // vote hashes by proposal
+    std::unordered_map<uint256, Tally, Hasher> ptallies GUARDED_BY(mu); // cached tallies by proposal
+    std::unordered_map<int, std::map<Proposal, Tally>> sbresults GUARDED_BY(mu); // cached superblock results
     std::unique_ptr<GovernanceDB> db;
 };
 
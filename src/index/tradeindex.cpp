@@ -0,0 +1,198 @@
+// Copyright (c) 2019 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/tradeindex.h>
+
+#include <util/system.h>
+#include <validation.h>
+#include <xbridge/currencypair.h>
+
+constexpr char DB_TRADE = 'h';
+
+std::unique_ptr<TradeIndex> g_tradeindex;
+
+extern CurrencyPair TxOutToCurrencyPair(const std::vector<CTxOut> & vout, std::string& snode_pubkey); // declared in rpcxbridge.cpp
+
+/**
+ * Trade records are keyed by block height and position in the block. Both
+ * are written big endian so that LevelDB orders the keys by height.
+ */
+struct TradeKey
+{
+    uint32_t height{0};
+    uint32_t pos{0};
+
+    TradeKey() = default;
+    TradeKey(uint32_t height, uint32_t pos) : height(height), pos(pos) {}
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        ser_writedata32be(s, height);
+        ser_writedata32be(s, pos);
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        height = ser_readdata32be(s);
+        pos = ser_readdata32be(s);
+    }
+};
+
+/**
+ * Access to the tradeindex database (indexes/tradeindex/)
+ */
+class TradeIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Replace the records at the given height.
+    bool WriteTrades(int height, const std::vector<TradeRecord>& records);
+
+    /// Erase the records at and above the given height.
+    bool EraseTrades(int start_height);
+
+    /// Read the records from start_height to end_height (inclusive).
+    bool ReadTrades(int start_height, int end_height, std::vector<TradeRecord>& records) const;
+
+private:
+    /// Add erases for the records from start_height to end_height (inclusive) to the batch.
+    void EraseRange(CDBBatch& batch, int start_height, int end_height) const;
+};
+
+TradeIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(GetDataDir() / "indexes" / "tradeindex", n_cache_size, f_memory, f_wipe)
+{}
+
+void TradeIndex::DB::EraseRange(CDBBatch& batch, int start_height, int end_height) const
+{
+    std::unique_ptr<CDBIterator> pcursor(const_cast<DB*>(this)->NewIterator());
+    std::pair<char, TradeKey> key;
+    for (pcursor->Seek(std::make_pair(DB_TRADE, TradeKey(start_height, 0))); pcursor->Valid(); pcursor->Next()) {
+        if (!pcursor->GetKey(key) || key.first != DB_TRADE || key.second.height > static_cast<uint32_t>(end_height))
+            break;
+        batch.Erase(key);
+    }
+}
+
+bool TradeIndex::DB::WriteTrades(int height, const std::vector<TradeRecord>& records)
+{
+    CDBBatch batch(*this);
+    EraseRange(batch, height, height); // records left by a block on a stale branch
+    for (uint32_t i = 0; i < records.size(); ++i)
+        batch.Write(std::make_pair(DB_TRADE, TradeKey(height, i)), records[i]);
+    return WriteBatch(batch);
+}
+
+bool TradeIndex::DB::EraseTrades(int start_height)
+{
+    CDBBatch batch(*this);
+    EraseRange(batch, start_height, std::numeric_limits<int>::max());
+    return WriteBatch(batch);
+}
+
+bool TradeIndex::DB::ReadTrades(int start_height, int end_height, std::vector<TradeRecord>& records) const
+{
+    std::unique_ptr<CDBIterator> pcursor(const_cast<DB*>(this)->NewIterator());
+    std::pair<char, TradeKey> key;
+    for (pcursor->Seek(std::make_pair(DB_TRADE, TradeKey(start_height, 0))); pcursor->Valid(); pcursor->Next()) {
+        if (!pcursor->GetKey(key) || key.first != DB_TRADE || key.second.height > static_cast<uint32_t>(end_height))
+            break;
+        TradeRecord record;
+        if (!pcursor->GetValue(record))
+            return error("%s: failed to read trade record at height %d", __func__, key.second.height);
+        records.push_back(std::move(record));
+    }
+    return true;
+}
+
+std::vector<TradeRecord> DecodeTrades(const CBlock& block, const int height)
+{
+    std::vector<TradeRecord> records;
+    for (const CTransactionRef & tx : block.vtx) {
+        std::string snode_pubkey{};
+        const CurrencyPair p = TxOutToCurrencyPair(tx->vout, snode_pubkey);
+        if (p.tag == CurrencyPair::Tag::Empty)
+            continue;
+
+        TradeRecord record;
+        record.height = height;
+        record.time = block.GetBlockTime();
+        record.txid = tx->GetHash();
+        if (p.tag == CurrencyPair::Tag::Error) {
+            record.error = p.error();
+        } else {
+            record.snodeAddress = snode_pubkey;
+            record.xid = p.xid();
+            record.fromCurrency = p.from.currency().to_string();
+            record.fromAmount = p.from.accumulator();
+            record.toCurrency = p.to.currency().to_string();
+            record.toAmount = p.to.accumulator();
+        }
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+TradeIndex::TradeIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(MakeUnique<TradeIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+TradeIndex::~TradeIndex() {}
+
+bool TradeIndex::Init()
+{
+    if (!BaseIndex::Init())
+        return false;
+
+    // Records above the fork point belong to blocks that are no longer in
+    // the active chain (or weren't covered by the last locator write),
+    // the sync thread writes them again.
+    const CBlockIndex* pindex = m_best_block_index.load();
+    return m_db->EraseTrades(pindex ? pindex->nHeight + 1 : 0);
+}
+
+bool TradeIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    return m_db->WriteTrades(pindex->nHeight, DecodeTrades(block, pindex->nHeight));
+}
+
+void TradeIndex::BlockDisconnected(const std::shared_ptr<const CBlock>& block)
+{
+    if (!m_synced) {
+        return;
+    }
+
+    const CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        pindex = LookupBlockIndex(block->GetHash());
+    }
+
+    // Only the index tip can be disconnected, anything else was never
+    // written (e.g. blocks queued before the sync thread caught up)
+    if (!pindex || pindex != m_best_block_index.load()) {
+        LogPrintf("%s: WARNING: Block %s is not the %s tip; not updating index\n",
+                  __func__, block->GetHash().ToString(), GetName());
+        return;
+    }
+
+    if (!m_db->EraseTrades(pindex->nHeight)) {
+        FatalError("%s: Failed to erase block %s from index",
+                   __func__, pindex->GetBlockHash().ToString());
+        return;
+    }
+    m_best_block_index = pindex->pprev;
+}
+
+BaseIndex::DB& TradeIndex::GetDB() const { return *m_db; }
+
+bool TradeIndex::FindTrades(int start_height, int end_height, std::vector<TradeRecord>& records) const
+{
+    if (start_height < 0)
+        start_height = 0;
+    if (end_height < start_height)
+        return true;
+    return m_db->ReadTrades(start_height, end_height, records);
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2019 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BLOCKNET_INDEX_TRADEINDEX_H
+#define BLOCKNET_INDEX_TRADEINDEX_H
+
+#include <chain.h>
+#include <index/base.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <string>
+#include <vector>
+
+/** Default for -tradeindex */
+static const bool DEFAULT_TRADEINDEX = true;
+
+/**
+ * XBridge trade (or trade decoding error) found in a block's fee transaction.
+ */
+struct TradeRecord
+{
+    int height{0};
+    int64_t time{0};
+    uint256 txid;
+    std::string snodeAddress;
+    std::string xid;
+    std::string fromCurrency;
+    uint64_t fromAmount{0};
+    std::string toCurrency;
+    uint64_t toAmount{0};
+    std::string error;
+
+    bool IsError() const { return !error.empty(); }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(height);
+        READWRITE(time);
+        READWRITE(txid);
+        READWRITE(snodeAddress);
+        READWRITE(xid);
+        READWRITE(fromCurrency);
+        READWRITE(fromAmount);
+        READWRITE(toCurrency);
+        READWRITE(toAmount);
+        READWRITE(error);
+    }
+};
+
+/**
+ * TradeIndex stores the XBridge trades decoded from the chain's fee
+ * transactions. Records are keyed by block height and position in the
+ * block, so a range of blocks is a single LevelDB range scan and a
+ * disconnected block is a prefix delete.
+ */
+class TradeIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+protected:
+    /// Override base class init to drop records above the fork point.
+    bool Init() override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    /// Drops the records of the disconnected tip.
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+    const char* GetName() const override { return "tradeindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit TradeIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~TradeIndex() override;
+
+    /// Returns true if the index is caught up with the active chain.
+    bool IsSynced() const { return m_synced; }
+
+    /// Returns the last block written to the index.
+    const CBlockIndex* BestBlockIndex() const { return m_best_block_index.load(); }
+
+    /// Look up the trades in blocks start_height to end_height (inclusive).
+    ///
+    /// @param[in]   start_height  The first block height.
+    /// @param[in]   end_height  The last block height.
+    /// @param[out]  records  The trades ordered by height and position in the block.
+    /// @return  false if the index could not be read
+    bool FindTrades(int start_height, int end_height, std::vector<TradeRecord>& records) const;
+};
+
+/// Decodes the trades in a block's transactions.
+std::vector<TradeRecord> DecodeTrades(const CBlock& block, int height);
+
+/// The global trade index. May be null.
+extern std::unique_ptr<TradeIndex> g_tradeindex;
+
+#endif // BLOCKNET_INDEX_TRADEINDEX_H
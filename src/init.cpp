@@ -24,6 +24,7 @@
 #include <httpserver.h>
 #include <httprpc.h>
 #include <interfaces/chain.h>
+#include <index/tradeindex.h>
 #include <index/txindex.h>
 #include <kernel.h>
 #include <key.h>
@@ -199,6 +200,9 @@ void Interrupt()
     if (g_txindex) {
         g_txindex->Interrupt();
     }
+    if (g_tradeindex) {
+        g_tradeindex->Interrupt();
+    }
 }
 
 void Shutdown(InitInterfaces& interfaces)
@@ -237,7 +241,12 @@ void Shutdown(InitInterfaces& interfaces)
     // using the other before destroying them.
     if (peerLogic) UnregisterValidationInterface(peerLogic.get());
     if (g_connman) g_connman->Stop();
+    sn::ServiceNodeMgr::instance().stopVerifyThreads();
     if (g_txindex) g_txindex->Stop();
+    if (g_tradeindex) {
+        UnregisterValidationInterface(g_tradeindex.get());
+        g_tradeindex->Stop();
+    }
 
     StopTorControl();
 
@@ -252,6 +261,10 @@ void Shutdown(InitInterfaces& interfaces)
     g_connman.reset();
     g_banman.reset();
     g_txindex.reset();
+    g_tradeindex.reset();
+#ifdef ENABLE_WALLET
+    g_staker.reset(); // no validation callbacks are in flight once the scheduler thread stopped
+#endif
 
     if (g_is_mempool_loaded && gArgs.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
         DumpMempool();
@@ -415,6 +428,7 @@ void SetupServerArgs()
     gArgs.AddArg("-reindex", "Rebuild chain state and block index from the blk*.dat files on disk", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-reindex-chainstate", "Rebuild chain state from the currently indexed blocks. When in pruning mode or if blocks on disk might be corrupted, use full -reindex instead.", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-staking", "Mine blocks on this node (default: 1). Can be used to specify search interval, staking=number_of_seconds (default: 15)", false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-stakingthreads=<n>", strprintf("Set the number of stake search threads (0 = auto, <0 = leave that many cores free, max: %d, default: %d)", 16, 0), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-stakingwithoutpeers", "Proceeds with staking even though no peers were detected. Mainly used for testing, this could put you on a fork. (default: 0)", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-minstakeamount", strprintf("Only stakes UTXOs greater than or equal to this amount (default: %d)", 0), false, OptionsCategory::OPTIONS);
 #ifndef WIN32
@@ -566,11 +580,14 @@ void SetupServerArgs()
 
     // XBridge
     gArgs.AddArg("-servicenode", strprintf("Auto register this service node on application start (default: %u)", false), false, OptionsCategory::XBRIDGE);
+    gArgs.AddArg("-servicenodeseenpackets=<n>", strprintf("Number of recent service node packets remembered to filter duplicates (default: %u, minimum: %u)", sn::DEFAULT_SNODE_SEEN_PACKETS, sn::MIN_SNODE_SEEN_PACKETS), false, OptionsCategory::XBRIDGE);
+    gArgs.AddArg("-servicenodeverifythreads=<n>", strprintf("Number of threads verifying service node pings and registrations, 0 verifies on the message handler (default: %d)", sn::DEFAULT_SNODE_VERIFY_THREADS), false, OptionsCategory::XBRIDGE);
     gArgs.AddArg("-enableexchange", strprintf("Enable exchange mode on this service node (default: %u)", false), false, OptionsCategory::XBRIDGE);
     gArgs.AddArg("-orderinputscheck", strprintf("Time interval for the utxo validity check on order inputs (default: %d seconds)", 900), false, OptionsCategory::XBRIDGE);
     gArgs.AddArg("-maxmempoolxbridge", strprintf("Maximum size in MB (megabytes) for the xbridge mempool (default: %dMB)", 128), false, OptionsCategory::XBRIDGE);
     gArgs.AddArg("-dxnowallets", strprintf("Show all orders across the network for non-local wallets"), false, OptionsCategory::XBRIDGE);
     gArgs.AddArg("-rpcxbridgetimeout", strprintf("Timeout for internal XBridge RPC calls (default: %d seconds)", 120), false, OptionsCategory::XBRIDGE);
+    gArgs.AddArg("-tradeindex", strprintf("Maintain an index of on-chain XBridge trades, used by the trading data rpc calls (default: %u)", DEFAULT_TRADEINDEX), false, OptionsCategory::XBRIDGE);
 
     // XRouter
     gArgs.AddArg("-xrouter", strprintf("Enable XRouter services (default: %u)", true), false, OptionsCategory::XROUTER);
@@ -1344,6 +1361,12 @@ bool AppInitMain(InitInterfaces& interfaces)
             threadGroup.create_thread(&ThreadScriptCheck);
     }
 
+    const int nSnodeVerifyThreads = gArgs.GetArg("-servicenodeverifythreads", sn::DEFAULT_SNODE_VERIFY_THREADS);
+    LogPrintf("Using %d threads for service node verification\n", std::max(nSnodeVerifyThreads, 0));
+    sn::ServiceNodeMgr::instance().startVerifyThreads(nSnodeVerifyThreads);
+    const int64_t nSnodeSeenPackets = gArgs.GetArg("-servicenodeseenpackets", sn::DEFAULT_SNODE_SEEN_PACKETS);
+    sn::ServiceNodeMgr::instance().setSeenPacketsSize(static_cast<unsigned int>(std::min<int64_t>(std::max<int64_t>(nSnodeSeenPackets, 0), std::numeric_limits<int32_t>::max())));
+
     // Start the lightweight task scheduler thread
     CScheduler::Function serviceLoop = std::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(std::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
@@ -1518,6 +1541,8 @@ bool AppInitMain(InitInterfaces& interfaces)
     nTotalCache -= nBlockTreeDBCache;
     int64_t nTxIndexCache = std::min(nTotalCache / 2, nMaxTxIndexCache << 20); // Blocknet PoS requires txindex
     nTotalCache -= nTxIndexCache;
+    int64_t nTradeIndexCache = gArgs.GetBoolArg("-tradeindex", DEFAULT_TRADEINDEX) ? std::min(nTotalCache / 8, nMaxTradeIndexCache << 20) : 0;
+    nTotalCache -= nTradeIndexCache;
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
@@ -1529,6 +1554,8 @@ bool AppInitMain(InitInterfaces& interfaces)
     LogPrintf("* Using %.1f MiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
     // Blocknet PoS requires txindex
         LogPrintf("* Using %.1f MiB for transaction index database\n", nTxIndexCache * (1.0 / 1024 / 1024));
+    if (gArgs.GetBoolArg("-tradeindex", DEFAULT_TRADEINDEX))
+        LogPrintf("* Using %.1f MiB for trade index database\n", nTradeIndexCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1f MiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1f MiB for in-memory UTXO set (plus up to %.1f MiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1f MiB for governance database\n", nGovDBCache * (1.0 / 1024 / 1024));
@@ -1722,6 +1749,12 @@ bool AppInitMain(InitInterfaces& interfaces)
 
     // ********************************************************* Step 8: start indexers
     // Blocknet PoS requires indexer to be started before chain load
+    if (gArgs.GetBoolArg("-tradeindex", DEFAULT_TRADEINDEX)) {
+        g_tradeindex = MakeUnique<TradeIndex>(nTradeIndexCache, false, fReindex);
+        // Register before starting so that no block is missed once the sync thread catches up
+        RegisterValidationInterface(g_tradeindex.get());
+        g_tradeindex->Start();
+    }
 
     // ********************************************************* Step 9: load wallet
     for (const auto& client : interfaces.chain_clients) {
@@ -3,6 +3,7 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <crypto/common.h>
 #include <hash.h>
 #include <kernel.h>
 #include <script/interpreter.h>
@@ -355,21 +356,19 @@ uint256 stakeHashV06(CDataStream ss, const uint256 & hashBlockFrom, const unsign
     return Hash(ss.begin(), ss.end());
 }
 
-bool stakeTargetHit(const uint256 & hashProofOfStake, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay) {
+arith_uint256 stakeTarget(const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay) {
     //get the stake weight - weight is equal to coin amount
     const auto bnCoinDayWeight = arith_uint256(nValueIn) / 100;
-    // Now check if proof-of-stake hash meets target protocol
-    return (UintToArith256(hashProofOfStake) < bnCoinDayWeight * bnTargetPerCoinDay);
+    return bnCoinDayWeight * bnTargetPerCoinDay;
 }
 
-bool stakeTargetHitV06(const uint256 & hashProofOfStake, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay) {
+arith_uint256 stakeTargetV06(const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay) {
     // Stake weight is 1/200 of the staked input amount
     const auto bnCoinDayWeight = arith_uint256(nValueIn) / 200;
-    // Now check if proof-of-stake hash meets target protocol
-    return (UintToArith256(hashProofOfStake) < bnCoinDayWeight * bnTargetPerCoinDay);
+    return bnCoinDayWeight * bnTargetPerCoinDay;
 }
 
-bool stakeTargetHitV07(const uint256 & hashProofOfStake, const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay, const int & nPowTargetSpacing) {
+int stakeWeightMultiplierV07(const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int & nPowTargetSpacing) {
     const auto numberOfSpaces = static_cast<double>(currentStakingTime - prevStakingTime) / nPowTargetSpacing;
     double multiplier{0};
     if (numberOfSpaces <= 1) { // if lte to target spacing
@@ -380,11 +379,144 @@ bool stakeTargetHitV07(const uint256 & hashProofOfStake, const int64_t & current
         multiplier = std::max<double>(1.0, pw);
         multiplier = std::min<double>(2.0, multiplier); // max 2x staking weight
     }
-    const auto stakeWeightMultiplier = arith_uint256(multiplier * 100);
+    return static_cast<int>(static_cast<uint64_t>(multiplier * 100));
+}
+
+arith_uint256 stakeTargetV07(const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay, const int & nPowTargetSpacing) {
+    const auto stakeWeightMultiplier = arith_uint256(stakeWeightMultiplierV07(currentStakingTime, prevStakingTime, nPowTargetSpacing));
     // Stake weight is 1/200 of the staked input amount multiplied by the multiplier with 100 denominator removed
     const auto bnCoinDayWeight = arith_uint256(nValueIn) * stakeWeightMultiplier / 100 / 100;
+    return bnCoinDayWeight * bnTargetPerCoinDay;
+}
+
+bool stakeTargetHit(const uint256 & hashProofOfStake, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay) {
+    // Now check if proof-of-stake hash meets target protocol
+    return (UintToArith256(hashProofOfStake) < stakeTarget(nValueIn, bnTargetPerCoinDay));
+}
+
+bool stakeTargetHitV06(const uint256 & hashProofOfStake, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay) {
+    // Now check if proof-of-stake hash meets target protocol
+    return (UintToArith256(hashProofOfStake) < stakeTargetV06(nValueIn, bnTargetPerCoinDay));
+}
+
+bool stakeTargetHitV07(const uint256 & hashProofOfStake, const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay, const int & nPowTargetSpacing) {
     // Now check if proof-of-stake hash meets target protocol
-    return (UintToArith256(hashProofOfStake) < bnCoinDayWeight * bnTargetPerCoinDay);
+    return (UintToArith256(hashProofOfStake) < stakeTargetV07(currentStakingTime, prevStakingTime, nValueIn, bnTargetPerCoinDay, nPowTargetSpacing));
+}
+
+StakeKernelHasher StakeKernelHasher::V03(const uint64_t & stakeModifier, const unsigned int & nTimeBlockFrom,
+        const unsigned int & prevoutIndex, const uint256 & prevoutHash)
+{
+    unsigned char prefix[48];
+    WriteLE64(prefix, stakeModifier);
+    WriteLE32(prefix + 8, nTimeBlockFrom);
+    WriteLE32(prefix + 12, prevoutIndex);
+    memcpy(prefix + 16, prevoutHash.begin(), 32);
+    StakeKernelHasher hasher;
+    hasher.midstate.Write(prefix, sizeof(prefix));
+    return hasher;
+}
+
+StakeKernelHasher StakeKernelHasher::V05(const uint64_t & stakeModifier, const unsigned int & nTimeBlockFrom,
+        const int & blockHeight, const unsigned int & prevoutIndex)
+{
+    unsigned char prefix[20];
+    WriteLE64(prefix, stakeModifier);
+    WriteLE32(prefix + 8, nTimeBlockFrom);
+    WriteLE32(prefix + 12, static_cast<uint32_t>(blockHeight));
+    WriteLE32(prefix + 16, prevoutIndex);
+    StakeKernelHasher hasher;
+    hasher.midstate.Write(prefix, sizeof(prefix));
+    return hasher;
+}
+
+StakeKernelHasher StakeKernelHasher::V06(const uint64_t & stakeModifier, const uint256 & hashBlockFrom,
+        const unsigned int & nTimeBlockFrom, const int & blockHeight, const unsigned int & prevoutIndex)
+{
+    unsigned char prefix[52];
+    WriteLE64(prefix, stakeModifier);
+    memcpy(prefix + 8, hashBlockFrom.begin(), 32);
+    WriteLE32(prefix + 40, nTimeBlockFrom);
+    WriteLE32(prefix + 44, static_cast<uint32_t>(blockHeight));
+    WriteLE32(prefix + 48, prevoutIndex);
+    StakeKernelHasher hasher;
+    hasher.midstate.Write(prefix, sizeof(prefix));
+    return hasher;
+}
+
+uint256 StakeKernelHasher::Hash(const unsigned int & nTimeTx) const {
+    uint256 result;
+    Hash(nTimeTx, 1, &result);
+    return result;
+}
+
+void StakeKernelHasher::Hash(const unsigned int & nTimeTx, size_t count, uint256 *out) const {
+    unsigned char time[4];
+    for (size_t i = 0; i < count; ++i) {
+        WriteLE32(time, nTimeTx + static_cast<unsigned int>(i));
+        CSHA256 sha = midstate;
+        sha.Write(time, sizeof(time)).Finalize(out[i].begin());
+        sha.Reset().Write(out[i].begin(), CSHA256::OUTPUT_SIZE).Finalize(out[i].begin());
+    }
+}
+
+StakeKernelTarget::StakeKernelTarget(const int64_t & blockTime, const int64_t & prevStakingTime, const int64_t & nValueIn,
+                                     const arith_uint256 & bnTargetPerCoinDay, const Consensus::Params & consensus)
+                                     : v07(IsProtocolV07(blockTime, consensus)), prevStakingTime(prevStakingTime),
+                                       nValueIn(nValueIn), nPowTargetSpacing(consensus.nPowTargetSpacing),
+                                       bnTargetPerCoinDay(bnTargetPerCoinDay)
+{
+    if (v07) {
+        targets.resize(MAX_MULTIPLIER + 1);
+        haveTargets.resize(MAX_MULTIPLIER + 1, false);
+    } else if (IsProtocolV06(blockTime, consensus))
+        target = ArithToUint256(stakeTargetV06(nValueIn, bnTargetPerCoinDay));
+    else
+        target = ArithToUint256(stakeTarget(nValueIn, bnTargetPerCoinDay));
+}
+
+bool StakeKernelTarget::Hit(const uint256 & hashProofOfStake, const int64_t & stakingTime) {
+    if (!v07)
+        return stakeHashBelowTarget(hashProofOfStake, target);
+    const auto multiplier = stakeWeightMultiplierV07(stakingTime, prevStakingTime, nPowTargetSpacing);
+    if (multiplier < 0 || multiplier > MAX_MULTIPLIER) // should never happen, fallback to full target computation
+        return stakeTargetHitV07(hashProofOfStake, stakingTime, prevStakingTime, nValueIn, bnTargetPerCoinDay, nPowTargetSpacing);
+    if (!haveTargets[multiplier]) {
+        targets[multiplier] = ArithToUint256(stakeTargetV07(stakingTime, prevStakingTime, nValueIn, bnTargetPerCoinDay, nPowTargetSpacing));
+        haveTargets[multiplier] = true;
+    }
+    return stakeHashBelowTarget(hashProofOfStake, targets[multiplier]);
+}
+
+bool stakeHashBelowTarget(const uint256 & hashProofOfStake, const uint256 & target) {
+    // uint256 is stored little endian, compare most significant words first
+    for (int i = 24; i >= 0; i -= 8) {
+        const auto a = ReadLE64(hashProofOfStake.begin() + i);
+        const auto b = ReadLE64(target.begin() + i);
+        if (a != b)
+            return a < b;
+    }
+    return false;
+}
+
+bool FindStakeKernel(const StakeKernelHasher & hasher, StakeKernelTarget & target, const int64_t & fromTime,
+        const int64_t & toTime, const int64_t & minTime, int64_t & stakeTime, uint256 & hashProofOfStake)
+{
+    static constexpr size_t BATCH = 16;
+    uint256 hashes[BATCH];
+    for (int64_t i = std::max(fromTime, minTime); i < toTime; i += BATCH) {
+        const auto count = static_cast<size_t>(std::min<int64_t>(BATCH, toTime - i));
+        hasher.Hash(static_cast<unsigned int>(i), count, hashes);
+        for (size_t j = 0; j < count; ++j) {
+            const auto time = i + static_cast<int64_t>(j);
+            if (!target.Hit(hashes[j], time))
+                continue;
+            stakeTime = time;
+            hashProofOfStake = hashes[j];
+            return true;
+        }
+    }
+    return false;
 }
 
 bool CheckStakeKernelHash(const CBlockIndex *pindexPrev, const CBlockIndex *pindexStake, const unsigned int & nBits,
@@ -7,6 +7,7 @@
 #define BITCOIN_KERNEL_H
 
 #include <chain.h>
+#include <crypto/sha256.h>
 #include <streams.h>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -26,6 +27,12 @@ uint256 stakeHash(unsigned int nTimeTx, CDataStream ss, unsigned int prevoutInde
 uint256 stakeHashV05(CDataStream ss, const unsigned int & nTimeBlockFrom, const int & blockHeight, const unsigned int & prevoutIndex, const unsigned int & nTimeTx);
 uint256 stakeHashV06(CDataStream ss, const uint256 & hashBlockFrom, const unsigned int & nTimeBlockFrom, const int & blockHeight, const unsigned int & prevoutIndex, const unsigned int & nTimeTx);
 
+// Stake targets (stake weight multiplied by the per coin day target)
+arith_uint256 stakeTarget(const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay);
+arith_uint256 stakeTargetV06(const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay);
+arith_uint256 stakeTargetV07(const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay, const int & nPowTargetSpacing);
+int stakeWeightMultiplierV07(const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int & nPowTargetSpacing);
+
 // Check whether stake kernel meets hash target
 bool stakeTargetHit(const uint256 & hashProofOfStake, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay);
 bool stakeTargetHitV06(const uint256 & hashProofOfStake, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay);
@@ -38,6 +45,58 @@ bool GetKernelStakeModifier(const CBlockIndex *pindexPrev, const CBlockIndex *pi
 bool GetKernelStakeModifierV03(const CBlockIndex *pindexStake, uint64_t & nStakeModifier, int & nStakeModifierHeight, int64_t & nStakeModifierTime);
 bool GetKernelStakeModifierBlocknet(const CBlockIndex *pindexPrev, const CBlockIndex *pindexStake, const int64_t & blockStakeTime, uint64_t & nStakeModifier, int & nStakeModifierHeight, int64_t & nStakeModifierTime);
 
+/**
+ * Stake kernel hasher for a single staking input. The per-coin constant prefix
+ * (stake modifier, block-from hash, block-from time, height and prevout index) is
+ * absorbed into a SHA256 midstate once, candidate timestamps only append their
+ * 4 bytes. Produces the same hashes as stakeHash, stakeHashV05 and stakeHashV06.
+ */
+class StakeKernelHasher {
+public:
+    static StakeKernelHasher V03(const uint64_t & stakeModifier, const unsigned int & nTimeBlockFrom, const unsigned int & prevoutIndex, const uint256 & prevoutHash);
+    static StakeKernelHasher V05(const uint64_t & stakeModifier, const unsigned int & nTimeBlockFrom, const int & blockHeight, const unsigned int & prevoutIndex);
+    static StakeKernelHasher V06(const uint64_t & stakeModifier, const uint256 & hashBlockFrom, const unsigned int & nTimeBlockFrom, const int & blockHeight, const unsigned int & prevoutIndex);
+
+    uint256 Hash(const unsigned int & nTimeTx) const;
+    /** Hash count consecutive timestamps starting at nTimeTx into out. */
+    void Hash(const unsigned int & nTimeTx, size_t count, uint256 *out) const;
+
+private:
+    StakeKernelHasher() = default;
+    CSHA256 midstate;
+};
+
+/**
+ * Stake target for a single staking input. Targets are held in hash byte order so
+ * that candidate kernel hashes are compared in place. V07 targets depend on the
+ * staking time only through the integer weight multiplier and are computed at most
+ * once per multiplier.
+ */
+class StakeKernelTarget {
+public:
+    explicit StakeKernelTarget(const int64_t & blockTime, const int64_t & prevStakingTime, const int64_t & nValueIn,
+                               const arith_uint256 & bnTargetPerCoinDay, const Consensus::Params & consensus);
+    bool Hit(const uint256 & hashProofOfStake, const int64_t & stakingTime);
+
+private:
+    static constexpr int MAX_MULTIPLIER = 200;
+    bool v07{false};
+    int64_t prevStakingTime{0};
+    int64_t nValueIn{0};
+    int nPowTargetSpacing{0};
+    arith_uint256 bnTargetPerCoinDay;
+    uint256 target;
+    std::vector<uint256> targets;
+    std::vector<bool> haveTargets;
+};
+
+// Compare a stake kernel hash against a target in hash byte order
+bool stakeHashBelowTarget(const uint256 & hashProofOfStake, const uint256 & target);
+
+// Sweep [fromTime, toTime) for the first timestamp meeting the target, skipping times before minTime
+bool FindStakeKernel(const StakeKernelHasher & hasher, StakeKernelTarget & target, const int64_t & fromTime,
+        const int64_t & toTime, const int64_t & minTime, int64_t & stakeTime, uint256 & hashProofOfStake);
+
 // Check kernel hash target and coinstake signature
 // Sets hashProofOfStake on success return
 bool CheckProofOfStake(const CBlockHeader & block, const CBlockIndex *pindexPrev, uint256 & hashProofOfStake, const Consensus::Params & consensusParams);
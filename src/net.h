@@ -574,6 +574,9 @@ public:
     double dPingWait;
     double dMinPing;
     CAmount minFeeFilter;
+    uint64_t nXBridgeRecv;
+    uint64_t nXBridgeSent;
+    uint64_t nXBridgeRouted;
     // Our address, as reported by the peer
     std::string addrLocal;
     // Address of this peer
@@ -715,6 +718,8 @@ public:
 
     // inventory based relay
     CRollingBloomFilter filterInventoryKnown GUARDED_BY(cs_inventory);
+    // XBridge packets this peer sent us or that we sent to it
+    CRollingBloomFilter filterXBridgeKnown GUARDED_BY(cs_inventory);
     // Set of transaction ids we still have to announce.
     // They are sorted by the mempool before relay, so the order is not important.
     std::set<uint256> setInventoryTxToSend;
@@ -764,6 +769,11 @@ public:
 
     std::atomic<bool> fXRouter{false};
 
+    // XBridge relay stats
+    std::atomic<uint64_t> nXBridgeRecv{0};
+    std::atomic<uint64_t> nXBridgeSent{0};
+    std::atomic<uint64_t> nXBridgeRouted{0};
+
 private:
     const NodeId id;
     const uint64_t nLocalHostNonce;
@@ -857,6 +867,16 @@ public:
         }
     }
 
+    // Returns false if the peer already has the xbridge packet, otherwise marks it as known
+    bool AddXBridgeKnown(const uint256& hash)
+    {
+        LOCK(cs_inventory);
+        if (filterXBridgeKnown.contains(hash))
+            return false;
+        filterXBridgeKnown.insert(hash);
+        return true;
+    }
+
     void PushInventory(const CInv& inv)
     {
         LOCK(cs_inventory);
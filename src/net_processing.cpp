@@ -739,6 +739,8 @@ PeerLogicValidation::PeerLogicValidation(CConnman* connmanIn, BanMan* banman, CS
     // timer.
     static_assert(EXTRA_PEER_CHECK_INTERVAL < STALE_CHECK_INTERVAL, "peer eviction timer should be less than stale tip check timer");
     scheduler.scheduleEvery(std::bind(&PeerLogicValidation::CheckForStaleTipAndEvictPeers, this, consensusParams), EXTRA_PEER_CHECK_INTERVAL * 1000);
+
+    m_xbridge_queue.start(1);
 }
 
 /**
@@ -1520,7 +1522,7 @@ void static ProcessOrphanTx(CConnman* connman, std::set<uint256>& orphan_work_se
     }
 }
 
-bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, int64_t nTimeReceived, const CChainParams& chainparams, CConnman* connman, const std::atomic<bool>& interruptMsgProc, bool enable_bip61)
+bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, int64_t nTimeReceived, const CChainParams& chainparams, CConnman* connman, PeerDispatchQueue& xbridgeQueue, const std::atomic<bool>& interruptMsgProc, bool enable_bip61)
 {
     LogPrint(BCLog::NET, "received: %s (%u bytes) peer=%d\n", SanitizeString(strCommand), vRecv.size(), pfrom->GetId());
     if (gArgs.IsArgSet("-dropmessagestest") && GetRand(gArgs.GetArg("-dropmessagestest", 0)) == 0)
@@ -2480,7 +2482,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         } // cs_main
 
         if (fProcessBLOCKTXN)
-            return ProcessMessage(pfrom, NetMsgType::BLOCKTXN, blockTxnMsg, nTimeReceived, chainparams, connman, interruptMsgProc, enable_bip61);
+            return ProcessMessage(pfrom, NetMsgType::BLOCKTXN, blockTxnMsg, nTimeReceived, chainparams, connman, xbridgeQueue, interruptMsgProc, enable_bip61);
 
         if (fRevertToHeaderProcessing) {
             // Headers received from HB compact block peers are permitted to be
@@ -2878,118 +2880,155 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             return true;
         }
 
-        int dos = 0;
+        // The sender has this packet, never relay it back
+        pfrom->AddXBridgeKnown(Hash(rawcopy.begin(), rawcopy.end()));
+        ++pfrom->nXBridgeRecv;
 
-        try {
-            // Process xbridge packet
-            if (!smgr.processXBridge(raw))
-                return true;
+        // Process the packet on the xbridge queue, misbehavior and relay are
+        // handled there once the packet is processed
+        const NodeId from = pfrom->GetId();
+        const std::string subVer = pfrom->cleanSubVer;
+        const bool queued = xbridgeQueue.push(from, [&smgr,&xapp,from,subVer,raw,rawcopy]() mutable {
+            int dos = 0;
 
-            CValidationState state;
+            try {
+                // Process xbridge packet
+                if (!smgr.processXBridge(raw))
+                    return;
 
-            // Pass packet to XBridge
-            if (xapp.isEnabled()) {
-                static std::vector<unsigned char> zero(20, 0);
-                std::vector<unsigned char> addr(raw.begin(), raw.begin()+20);
-                raw.erase(raw.begin(), raw.begin()+20); // remove addr from raw
-                raw.erase(raw.begin(), raw.begin()+sizeof(uint64_t)); // remove timestamp from raw
-                if (addr != zero)
-                    xapp.onMessageReceived(addr, raw, state);
-                else
-                    xapp.onBroadcastReceived(raw, state);
-
-                if (state.IsInvalid(dos)) {
-                    LogPrint(BCLog::XBRIDGE, "invalid xbridge packet from peer=%d %s : %s\n", pfrom->GetId(),
-                            pfrom->cleanSubVer, state.GetRejectReason());
-                    if (dos > 0) {
-                        LOCK(cs_main);
-                        Misbehaving(pfrom->GetId(), dos);
+                CValidationState state;
+
+                // Pass packet to XBridge
+                if (xapp.isEnabled()) {
+                    static std::vector<unsigned char> zero(20, 0);
+                    std::vector<unsigned char> addr(raw.begin(), raw.begin()+20);
+                    raw.erase(raw.begin(), raw.begin()+20); // remove addr from raw
+                    raw.erase(raw.begin(), raw.begin()+sizeof(uint64_t)); // remove timestamp from raw
+                    if (addr != zero)
+                        xapp.onMessageReceived(addr, raw, state);
+                    else
+                        xapp.onBroadcastReceived(raw, state);
+
+                    if (state.IsInvalid(dos)) {
+                        LogPrint(BCLog::XBRIDGE, "invalid xbridge packet from peer=%d %s : %s\n", from,
+                                subVer, state.GetRejectReason());
+                        if (dos > 0) {
+                            LOCK(cs_main);
+                            Misbehaving(from, dos);
+                        }
+                    }
+                    else if (state.IsError()) {
+                        LogPrint(BCLog::XBRIDGE, "xbridge packet from peer=%d %s processed with error: %s\n",
+                                 from, subVer, state.GetRejectReason());
                     }
                 }
-                else if (state.IsError()) {
-                    LogPrint(BCLog::XBRIDGE, "xbridge packet from peer=%d %s processed with error: %s\n",
-                             pfrom->GetId(), pfrom->cleanSubVer,
-                             state.GetRejectReason());
-                }
+            } catch (...) {
+                LogPrint(BCLog::XBRIDGE, "Fatal XBridge error detected\n");
             }
-        } catch (...) {
-            LogPrint(BCLog::XBRIDGE, "Fatal XBridge error detected\n");
-        }
 
-        // Relay xbridge packets only if state is good
-        if (dos <= 0) {
-            connman->ForEachNode([&](CNode *pnode) {
-                if (!pnode->fSuccessfullyConnected)
-                    return;
-                connman->PushMessage(pnode, msgMaker.Make(NetMsgType::XBRIDGE, rawcopy));
-            });
-        }
+            // Relay xbridge packets only if state is good
+            if (dos <= 0)
+                xapp.relayPacket(rawcopy, from);
+        });
+
+        if (!queued)
+            LogPrint(BCLog::XBRIDGE, "xbridge queue full, dropping packet from peer=%d\n", from);
 
         return true;
     }
 
+    // Servicenode packets are verified on the servicenode verification threads,
+    // relay happens once the packet is verified.
+    auto onSnodeError = [](const NodeId from) {
+        return [from](const std::string & err) {
+            LOCK(cs_main);
+            LogPrint(BCLog::NET, "servicenode packet from peer=%d verified with error: %s\n", from, err);
+            // bad packet, small penalty
+            Misbehaving(from, 10);
+        };
+    };
+
     if (strCommand == NetMsgType::SNREGISTER) { // handle snode registrations
-        sn::ServiceNode snode;
+        const NodeId from = pfrom->GetId();
+        const int sendVersion = pfrom->GetSendVersion();
+        auto onValid = [connman,from,sendVersion](const sn::ServiceNode & snode) {
+            auto & smgr = sn::ServiceNodeMgr::instance();
+            // Send the ping out if we are a snode waiting for registration
+            if (smgr.hasActiveSn() && smgr.getActiveSn().keyId() == snode.getSnodePubKey().GetID()) {
+                sn::ServiceNodeMgr::writeSnRegistration(snode);
+                if (!smgr.sendPing(XROUTER_PROTOCOL_VERSION, xbridge::App::instance().myServicesJSON(), connman))
+                    LogPrintf("Service node ping failed after registration for %s\n", smgr.getActiveSn().alias);
+            }
+
+            // Relay packets
+            const CNetMsgMaker msgMaker(sendVersion);
+            connman->ForEachNode([&](CNode* pnode) {
+                if (pnode->GetId() == from)
+                    return;
+                connman->PushMessage(pnode, msgMaker.Make(NetMsgType::SNREGISTER, snode));
+            });
+        };
         try {
-            if (!smgr.processRegistration(vRecv, snode))
-                return true;
+            smgr.queueRegistration(vRecv, onValid, onSnodeError(from));
         } catch (std::exception & e) {
             LOCK(cs_main);
             LogPrint(BCLog::NET, "servicenode packet from peer=%d %s processed with error: %s\n",
                      pfrom->GetId(), pfrom->cleanSubVer, std::string(e.what()));
             // bad packet, small penalty
             Misbehaving(pfrom->GetId(), 10);
-            return true;
-        }
-
-        // Send the ping out if we are a snode waiting for registration
-        if (smgr.hasActiveSn() && smgr.getActiveSn().keyId() == snode.getSnodePubKey().GetID()) {
-            sn::ServiceNodeMgr::writeSnRegistration(snode);
-            if (!smgr.sendPing(XROUTER_PROTOCOL_VERSION, xapp.myServicesJSON(), connman))
-                LogPrintf("Service node ping failed after registration for %s\n", smgr.getActiveSn().alias);
         }
 
-        // Relay packets
-        connman->ForEachNode([&](CNode* pnode) {
-            if (pfrom == pnode)
-                return;
-            connman->PushMessage(pnode, msgMaker.Make(NetMsgType::SNREGISTER, snode));
-        });
-
         return true;
     }
 
     if (strCommand == NetMsgType::SNPING || strCommand == NetMsgType::SNLISTPING) { // handle snode pings
-        sn::ServiceNodePing ping;
+        const NodeId from = pfrom->GetId();
+        const int sendVersion = pfrom->GetSendVersion();
+        // Relay packets only on SNPING (not SNLISTPING)
+        const bool relay = strCommand == NetMsgType::SNPING;
+        auto onValid = [connman,from,sendVersion,relay](const sn::ServiceNodePing & ping) {
+            if (relay) {
+                // The peer that relayed this ping first is one of the routes to this snode's xbridge address
+                const auto snodeId = ping.getSnodePubKey().GetID();
+                xbridge::App::instance().addRoute(std::vector<unsigned char>(snodeId.begin(), snodeId.end()), from);
+
+                const CNetMsgMaker msgMaker(sendVersion);
+                connman->ForEachNode([&](CNode* pnode) {
+                    if (pnode->GetId() == from)
+                        return;
+                    connman->PushMessage(pnode, msgMaker.Make(NetMsgType::SNPING, ping));
+                });
+            }
+
+            bool isReady = xrouter::App::isEnabled() && xrouter::App::instance().isReady();
+            if (isReady)
+                xrouter::App::instance().processConfigMessage(ping.getSnode());
+        };
         try {
-            if (!smgr.processPing(vRecv, ping))
-                return true;
+            smgr.queuePing(vRecv, onValid, false, onSnodeError(from));
         } catch (std::exception & e) {
             LOCK(cs_main);
             LogPrint(BCLog::NET, "servicenode packet from peer=%d %s processed with error: %s\n",
                      pfrom->GetId(), pfrom->cleanSubVer, std::string(e.what()));
             // bad packet, small penalty
             Misbehaving(pfrom->GetId(), 10);
-            return true;
-        }
-
-        // Relay packets only on SNPING (not SNLISTPING)
-        if (strCommand == NetMsgType::SNPING) {
-            connman->ForEachNode([&](CNode* pnode) {
-                if (pfrom == pnode)
-                    return;
-                connman->PushMessage(pnode, msgMaker.Make(NetMsgType::SNPING, ping));
-            });
         }
 
-        bool isReady = xrouter::App::isEnabled() && xrouter::App::instance().isReady();
-        if (isReady)
-            xrouter::App::instance().processConfigMessage(ping.getSnode());
-
         return true;
     }
 
     if (strCommand == NetMsgType::SNLIST) { // handle snode list requests
+        if (!vRecv.empty()) { // paged list request, reply with a single SNLISTBULK message
+            sn::ServiceNodeListCursor cursor;
+            vRecv >> cursor;
+            sn::ServiceNodeListCursor next;
+            bool more{false};
+            const auto & pings = smgr.getPings(cursor, next, more);
+            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNLISTBULK, pings, next, more));
+            return true;
+        }
+
+        // Legacy list request, one SNLISTPING message per snode
         const auto & snlist = smgr.list();
         for (const auto & snode : snlist) {
             const auto & ping = smgr.getPing(snode.getSnodePubKey());
@@ -3000,6 +3039,37 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         return true;
     }
 
+    if (strCommand == NetMsgType::SNLISTBULK) { // handle snode list pages
+        std::vector<sn::ServiceNodePing> pings;
+        sn::ServiceNodeListCursor next;
+        bool more{false};
+        try {
+            vRecv >> pings >> next >> more;
+        } catch (std::exception & e) {
+            LOCK(cs_main);
+            LogPrint(BCLog::NET, "servicenode packet from peer=%d %s processed with error: %s\n",
+                     pfrom->GetId(), pfrom->cleanSubVer, std::string(e.what()));
+            // bad packet, small penalty
+            Misbehaving(pfrom->GetId(), 10);
+            return true;
+        }
+
+        auto onValid = [](const sn::ServiceNodePing & ping) {
+            bool isReady = xrouter::App::isEnabled() && xrouter::App::instance().isReady();
+            if (isReady)
+                xrouter::App::instance().processConfigMessage(ping.getSnode());
+        };
+        const auto onError = onSnodeError(pfrom->GetId());
+        for (const auto & ping : pings)
+            smgr.queuePing(ping, onValid, false, onError);
+
+        // Request the next page, pages must make progress
+        if (more && !pings.empty())
+            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNLIST, next));
+
+        return true;
+    }
+
     if (strCommand == NetMsgType::XROUTER) { // handle xrouter packets
         bool isReady = xrouter::App::isEnabled() && xrouter::App::instance().isReady();
         if (isReady) {
@@ -3148,7 +3218,7 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     bool fRet = false;
     try
     {
-        fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc, m_enable_bip61);
+        fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, m_xbridge_queue, interruptMsgProc, m_enable_bip61);
         if (interruptMsgProc)
             return false;
         if (!pfrom->vRecvGetData.empty())
@@ -11,6 +11,7 @@
 #include <net.h>
 #include <validationinterface.h>
 #include <consensus/params.h>
+#include <dispatchqueue.h>
 #include <sync.h>
 
 extern CCriticalSection cs_main;
@@ -24,6 +25,10 @@ static const unsigned int DEFAULT_MAX_ORPHAN_TRANSACTIONS = 100;
 static const unsigned int DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN = 100;
 /** Default for BIP61 (sending reject messages) */
 static constexpr bool DEFAULT_ENABLE_BIP61{true};
+/** Maximum number of xbridge packets waiting to be processed */
+static const unsigned int MAX_XBRIDGE_QUEUED_PACKETS = 5000;
+/** Maximum number of xbridge packets waiting to be processed per peer */
+static const unsigned int MAX_XBRIDGE_QUEUED_PEER_PACKETS = 500;
 
 class PeerLogicValidation final : public CValidationInterface, public NetEventsInterface {
 private:
@@ -82,6 +87,10 @@ private:
 
     /** Enable BIP61 (sending reject messages) */
     const bool m_enable_bip61;
+
+    /** XBridge packets are processed off the message handler thread, a single
+     *  worker keeps the packets in the order they were received */
+    PeerDispatchQueue m_xbridge_queue{"xbridge", MAX_XBRIDGE_QUEUED_PACKETS, MAX_XBRIDGE_QUEUED_PEER_PACKETS};
 };
 
 struct CNodeStateStats {
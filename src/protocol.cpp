@@ -47,6 +47,7 @@ const char *SNREGISTER="snr";
 const char *SNPING="snp";
 const char *SNLIST="snl";
 const char *SNLISTPING="snlp";
+const char *SNLISTBULK="snlb";
 const char *XROUTER="xrouter";
 } // namespace NetMsgType
 
@@ -85,6 +86,7 @@ const static std::string allNetMessageTypes[] = {
     NetMsgType::SNPING,
     NetMsgType::SNLIST,
     NetMsgType::SNLISTPING,
+    NetMsgType::SNLISTBULK,
     NetMsgType::XROUTER,
 };
 const static std::vector<std::string> allNetMessageTypesVec(allNetMessageTypes, allNetMessageTypes+ARRAYLEN(allNetMessageTypes));
@@ -263,6 +263,12 @@ extern const char *SNLIST;
  * @since protocol version 70713
  */
 extern const char *SNLISTPING;
+/**
+ * Contains a page of Service Node pings, the reply to an SNLIST request
+ * that carries a list cursor.
+ * @since protocol version 70713
+ */
+extern const char *SNLISTBULK;
 /**
  * Contains an XRouter message.
  * @since protocol version 70712
@@ -164,8 +164,7 @@ static UniValue listproposals(const JSONRPCRequest& request)
             if (results.count(proposal))
                 status = "passed";
         }
-        const auto votes = gov::Governance::instance().getVotes(proposal.getHash());
-        const auto tally = gov::Governance::getTally(proposal.getHash(), votes, consensus);
+        const auto tally = gov::Governance::instance().getTally(proposal.getHash(), consensus);
         UniValue prop(UniValue::VOBJ);
         prop.pushKV("hash", proposal.getHash().ToString());
         prop.pushKV("name", proposal.getName());
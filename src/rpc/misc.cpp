@@ -413,6 +413,15 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCProofOfStakeMemoryInfo()
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", uint64_t(HashProofOfStakeCacheSize()));
+    obj.pushKV("usage", uint64_t(HashProofOfStakeCacheUsage()));
+    obj.pushKV("max_entries", uint64_t(MAX_PROOF_OF_STAKE_CACHE));
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -456,6 +465,11 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"proofofstake\": {         (json object) Information about the proof-of-stake hash cache\n"
+            "    \"entries\": xxxxx,       (numeric) Number of cached hashes for blocks not yet in the block index\n"
+            "    \"usage\": xxxxx,         (numeric) Memory usage of the cache in bytes\n"
+            "    \"max_entries\": xxxxx,   (numeric) Maximum number of cached hashes\n"
             "  }\n"
             "}\n"
                     },
@@ -473,6 +487,7 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("proofofstake", RPCProofOfStakeMemoryInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -125,6 +125,11 @@ static UniValue getpeerinfo(const JSONRPCRequest& request)
             "                               When a message type is not listed in this json object, the bytes received are 0.\n"
             "                               Only known message types can appear as keys in the object and all bytes received of unknown message types are listed under '"+NET_MESSAGE_COMMAND_OTHER+"'.\n"
             "       ...\n"
+            "    },\n"
+            "    \"xbridge\": {\n"
+            "       \"received\": n,          (numeric) The number of xbridge packets received from this peer\n"
+            "       \"sent\": n,              (numeric) The number of xbridge packets sent to this peer\n"
+            "       \"routed\": n,            (numeric) The number of sent xbridge packets routed only to this peer\n"
             "    }\n"
             "  }\n"
             "  ,...\n"
@@ -203,6 +208,12 @@ static UniValue getpeerinfo(const JSONRPCRequest& request)
         }
         obj.pushKV("bytesrecv_per_msg", recvPerMsgCmd);
 
+        UniValue xbridgeStats(UniValue::VOBJ);
+        xbridgeStats.pushKV("received", stats.nXBridgeRecv);
+        xbridgeStats.pushKV("sent", stats.nXBridgeSent);
+        xbridgeStats.pushKV("routed", stats.nXBridgeRouted);
+        obj.pushKV("xbridge", xbridgeStats);
+
         ret.push_back(obj);
     }
 
@@ -6,6 +6,7 @@
 #define BLOCKNET_SERVICENODE_SERVICENODEMGR_H
 
 #include <amount.h>
+#include <bloom.h>
 #include <key_io.h>
 #include <net.h>
 #include <netmessagemaker.h>
@@ -21,9 +22,14 @@
 #include <wallet/wallet.h>
 #endif // ENABLE_WALLET
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <list>
 #include <numeric>
 #include <set>
+#include <thread>
 #include <utility>
 
 #include <boost/algorithm/string.hpp>
@@ -36,6 +42,17 @@ namespace sn {
 
 extern CTxDestination ServiceNodePaymentAddress(const std::string & snode);
 
+/** Default number of threads verifying servicenode pings and registrations (0 verifies on the message handler) */
+static const int DEFAULT_SNODE_VERIFY_THREADS = 2;
+/** Max number of packets waiting for verification, additional packets are verified on the message handler */
+static const size_t MAX_SNODE_VERIFY_QUEUE = 10000;
+/** Default number of recent servicenode packet hashes remembered for duplicate detection */
+static const unsigned int DEFAULT_SNODE_SEEN_PACKETS = 350000;
+static const unsigned int MIN_SNODE_SEEN_PACKETS = 10000;
+static const double SNODE_SEEN_PACKETS_FP_RATE = 0.000001;
+/** Max serialized size in bytes of the pings in one servicenode list page */
+static const size_t MAX_SNODE_LIST_PAGE_SIZE = 1000000;
+
 /**
  * Hasher used with unordered_map and unordered_set
  */
@@ -43,6 +60,50 @@ struct Hasher {
     size_t operator()(const CPubKey & pubkey) const { return ReadLE64(pubkey.begin()); }
 };
 
+/**
+ * Position in the servicenode ping list, which is ordered by ping time and then by snode
+ * pubkey. An SNLIST request carrying a cursor asks for the pings after this position, the
+ * default cursor asks for the entire list.
+ */
+struct ServiceNodeListCursor {
+    uint32_t pingTime{0};
+    CPubKey snodePubKey;
+
+    ServiceNodeListCursor() = default;
+    ServiceNodeListCursor(const uint32_t pingTime, const CPubKey & snodePubKey) : pingTime(pingTime),
+                                                                                  snodePubKey(snodePubKey) {}
+
+    friend inline bool operator<(const ServiceNodeListCursor & a, const ServiceNodeListCursor & b) {
+        if (a.pingTime != b.pingTime)
+            return a.pingTime < b.pingTime;
+        return a.snodePubKey < b.snodePubKey;
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(pingTime);
+        READWRITE(snodePubKey);
+    }
+};
+
+/**
+ * Servicenode ping or registration waiting on signature and collateral verification.
+ */
+struct ServiceNodeVerifyItem {
+    bool isPing{false};
+    bool skipValidation{false};
+    ServiceNodePing ping;
+    ServiceNode snode;
+    std::function<void(const ServiceNodePing & ping)> onPing;
+    std::function<void(const ServiceNode & snode)> onRegistration;
+    std::function<void(const std::string & err)> onError; // verification threw, e.g. to penalize the sender
+    bool done{false};
+    bool valid{false};
+};
+typedef std::shared_ptr<ServiceNodeVerifyItem> ServiceNodeVerifyItemPtr;
+
 /**
  * Service node configuration entry (from servicenode.conf).
  */
@@ -77,6 +138,9 @@ struct ServiceNodeConfigEntry {
 class ServiceNodeMgr : public CValidationInterface {
 public:
     ServiceNodeMgr() = default;
+    ~ServiceNodeMgr() {
+        stopVerifyThreads();
+    }
 
     /**
      * Singleton instance.
@@ -93,10 +157,17 @@ public:
     void reset() {
         LOCK(mu);
         snodes.clear();
+        collateralIndex.clear();
         pings.clear();
-        seenPackets.clear();
+        seenPackets.reset();
         snodeEntries.clear();
         seenBlocks.clear();
+        {
+            LOCK(collateralMu);
+            collateralTxs.clear();
+            collateralLru.clear();
+            ++collateralGeneration;
+        }
     }
 
     /**
@@ -180,19 +251,151 @@ public:
         } catch (...) {
             return false;
         }
+        return processPing(ping, skipValidation);
+    }
+
+    /**
+     * Processes a servicenode ping, e.g. from a servicenode list page.
+     * @param ping
+     * @param skipValidation If true the validation checks are skipped.
+     * @return
+     */
+    bool processPing(const ServiceNodePing & ping, const bool skipValidation = false) {
         if (seenPacket(ping.getHash()))
             return false;
 
-        if (!ping.isValid(GetTxFunc, IsServiceNodeBlockValidFunc, skipValidation))
+        if (!ping.isValid(collateralTxFunc(), IsServiceNodeBlockValidFunc, skipValidation))
             return false; // bad ping
 
-        if (!addPing(ping))
+        return applyPing(ping);
+    }
+
+    /**
+     * Queues a servicenode registration message from the network for verification on the
+     * verification threads. Verified registrations are added in arrival order and then
+     * passed to onValid. Returns false if the packet was already seen, throws if the
+     * packet is malformed.
+     * @param ss
+     * @param onValid
+     * @param onError Called if verification fails with an error.
+     * @return
+     */
+    bool queueRegistration(CDataStream & ss, std::function<void(const ServiceNode & snode)> onValid,
+                           std::function<void(const std::string & err)> onError = nullptr)
+    {
+        auto item = std::make_shared<ServiceNodeVerifyItem>();
+        ss >> item->snode;
+        if (seenPacket(item->snode.getHash()))
             return false;
+        item->onRegistration = std::move(onValid);
+        item->onError = std::move(onError);
+        queueVerify(item);
+        return true;
+    }
 
-        addSn(ping.getSnode(), false); // skip validity check here because it's checked in the ping's
+    /**
+     * Queues a servicenode ping message from the network for verification on the
+     * verification threads. Verified pings are added in arrival order and then passed
+     * to onValid. Returns false if the packet was already seen, throws if the packet is
+     * malformed.
+     * @param ss
+     * @param onValid
+     * @param skipValidation If true the blockchain validation checks are skipped.
+     * @param onError Called if verification fails with an error.
+     * @return
+     */
+    bool queuePing(CDataStream & ss, std::function<void(const ServiceNodePing & ping)> onValid,
+                   const bool skipValidation = false,
+                   std::function<void(const std::string & err)> onError = nullptr)
+    {
+        ServiceNodePing ping;
+        ss >> ping;
+        return queuePing(ping, std::move(onValid), skipValidation, std::move(onError));
+    }
+
+    /**
+     * Queues a servicenode ping for verification, e.g. from a servicenode list page.
+     * Returns false if the ping was already seen.
+     * @param ping
+     * @param onValid
+     * @param skipValidation If true the blockchain validation checks are skipped.
+     * @param onError Called if verification fails with an error.
+     * @return
+     */
+    bool queuePing(const ServiceNodePing & ping, std::function<void(const ServiceNodePing & ping)> onValid,
+                   const bool skipValidation = false,
+                   std::function<void(const std::string & err)> onError = nullptr)
+    {
+        if (seenPacket(ping.getHash()))
+            return false;
+        auto item = std::make_shared<ServiceNodeVerifyItem>();
+        item->ping = ping;
+        item->isPing = true;
+        item->skipValidation = skipValidation;
+        item->onPing = std::move(onValid);
+        item->onError = std::move(onError);
+        queueVerify(item);
         return true;
     }
 
+    /**
+     * Starts the servicenode verification threads. With 0 threads queued packets are
+     * verified on the calling thread.
+     * @param threads
+     */
+    void startVerifyThreads(const int threads) {
+        LOCK(verifyMu);
+        if (!verifyThreads.empty())
+            return; // already started
+        stopVerify = false;
+        for (int i = 0; i < threads; ++i) {
+            verifyThreads.emplace_back([this]() {
+                RenameThread("blocknet-snverify");
+                verifyThread();
+            });
+        }
+    }
+
+    /**
+     * Stops the servicenode verification threads. Packets that have not been verified
+     * yet are dropped.
+     */
+    void stopVerifyThreads() {
+        std::vector<std::thread> threads;
+        {
+            LOCK(verifyMu);
+            stopVerify = true;
+            verifyPending.clear();
+            threads.swap(verifyThreads);
+        }
+        verifyCond.notify_all();
+        for (auto & t : threads)
+            t.join();
+        {
+            LOCK(verifyMu);
+            verifyOrdered.clear();
+        }
+        verifyDoneCond.notify_all();
+    }
+
+    /**
+     * Blocks until all queued packets have been verified and applied.
+     */
+    void waitForVerifyQueue() {
+        WAIT_LOCK(verifyMu, lock);
+        verifyDoneCond.wait(lock, [this]() { return verifyOrdered.empty(); });
+    }
+
+    /**
+     * Resizes the seen packets filter to remember at least the specified number of
+     * recent packets. Previously seen packets are forgotten.
+     * @param packets
+     */
+    void setSeenPacketsSize(const unsigned int packets) {
+        LOCK(mu);
+        seenPackets = CRollingBloomFilter(std::max(packets, MIN_SNODE_SEEN_PACKETS), SNODE_SEEN_PACKETS_FP_RATE);
+    }
+
 #ifdef ENABLE_WALLET
     /**
      * Registers a snode on the network. This will also automatically search the wallet for required collateral.
@@ -268,12 +471,9 @@ public:
             std::set<COutPoint> alreadyAllocatedUtxos;
             {
                 LOCK(mu);
-                for (const auto & item : snodes) {
-                    const auto & s = item.second;
-                    if (s->getSnodePubKey() != snodePubKey) { // exclude registering snode
-                        const auto & c = s->getCollateral();
-                        alreadyAllocatedUtxos.insert(c.begin(), c.end());
-                    }
+                for (const auto & item : collateralIndex) {
+                    if (item.second != snodePubKey) // exclude registering snode
+                        alreadyAllocatedUtxos.insert(item.first);
                 }
             }
 
@@ -363,7 +563,7 @@ public:
 
         ServiceNodePing ping(activesn.key.GetPubKey(), bestBlock, bestBlockHash, static_cast<uint32_t>(GetTime()), config, *snode);
         ping.sign(activesn.key);
-        if (!ping.isValid(GetTxFunc, IsServiceNodeBlockValidFunc)) {
+        if (!ping.isValid(collateralTxFunc(), IsServiceNodeBlockValidFunc)) {
             LogPrint(BCLog::SNODE, "service node ping failed\n");
             return false;
         }
@@ -410,6 +610,51 @@ public:
         return pings[snodePubKey];
     }
 
+    /**
+     * Returns a page of the pings of known servicenodes that come after the cursor, in
+     * ping time order. The page holds at least one ping and stops before maxBytes. next
+     * is set to the position of the last ping in the page and more is set if pings
+     * remain after it.
+     * @param cursor
+     * @param next
+     * @param more
+     * @param maxBytes
+     * @return
+     */
+    std::vector<ServiceNodePing> getPings(const ServiceNodeListCursor & cursor, ServiceNodeListCursor & next,
+                                          bool & more, const size_t maxBytes = MAX_SNODE_LIST_PAGE_SIZE)
+    {
+        LOCK(mu);
+        std::vector<std::pair<ServiceNodeListCursor, const ServiceNodePing*>> sorted;
+        sorted.reserve(pings.size());
+        for (const auto & item : pings) {
+            const ServiceNodeListCursor pos(item.second.getPingTime(), item.first);
+            if (cursor < pos && snodes.count(item.first))
+                sorted.emplace_back(pos, &item.second);
+        }
+        std::sort(sorted.begin(), sorted.end(),
+            [](const std::pair<ServiceNodeListCursor, const ServiceNodePing*> & a,
+               const std::pair<ServiceNodeListCursor, const ServiceNodePing*> & b) {
+                return a.first < b.first;
+            });
+
+        std::vector<ServiceNodePing> page;
+        size_t bytes{0};
+        next = cursor;
+        more = false;
+        for (const auto & item : sorted) {
+            const auto size = GetSerializeSize(*item.second, PROTOCOL_VERSION);
+            if (!page.empty() && bytes + size > maxBytes) {
+                more = true;
+                break;
+            }
+            page.push_back(*item.second);
+            bytes += size;
+            next = item.first;
+        }
+        return page;
+    }
+
     /**
      * Returns the servicenode with the specified pubkey.
      * @param snodePubKey
@@ -516,7 +761,7 @@ public:
     void removeSnEntries() {
         LOCK(mu);
         for (const auto & entry : snodeEntries)
-            snodes.erase(entry.key.GetPubKey());
+            eraseSn(entry.key.GetPubKey());
         snodeEntries.clear();
     }
 
@@ -859,13 +1104,13 @@ protected:
      * @return
      */
     ServiceNodePtr addSn(const ServiceNode & snode, const bool checkValid = true, const bool staleCheck = true) {
-        if (checkValid && !snode.isValid(GetTxFunc, IsServiceNodeBlockValidFunc, staleCheck))
+        if (checkValid && !snode.isValid(collateralTxFunc(), IsServiceNodeBlockValidFunc, staleCheck))
             return nullptr;
         removeSnWithCollateral(snode);
         auto ptr = std::make_shared<ServiceNode>(snode);
         {
             LOCK(mu);
-            snodes[ptr->getSnodePubKey()] = ptr;
+            insertSn(ptr);
         }
         return ptr;
     }
@@ -900,7 +1145,7 @@ protected:
         if (!hasSn(snodePubKey))
             return false;
         LOCK(mu);
-        snodes.erase(snodePubKey);
+        eraseSn(snodePubKey);
         return true;
     }
 
@@ -921,11 +1166,9 @@ protected:
      */
     bool seenPacket(const uint256 & hash) {
         LOCK(mu);
-        if (seenPackets.count(hash))
+        if (seenPackets.contains(hash))
             return true; // already seen
-        if (seenPackets.size() > 350000)
-            seenPackets.clear(); // mem mgmt, ~12MB (32bytes * 350k)
-        seenPackets.insert(hash);
+        seenPackets.insert(hash); // oldest hashes roll off once the filter is full
         return false;
     }
 
@@ -939,6 +1182,219 @@ protected:
         return seenPacket(hash);
     }
 
+    /**
+     * Adds the verified ping and its servicenode. Returns false if a newer ping is known.
+     * @param ping
+     * @return
+     */
+    bool applyPing(const ServiceNodePing & ping) {
+        if (!addPing(ping))
+            return false;
+        addSn(ping.getSnode(), false); // skip validity check here because it's checked in the ping's
+        return true;
+    }
+
+    /**
+     * Verifies the queued ping or registration signatures and collateral. Runs on the
+     * verification threads, an item that fails with an error is invalid and reported
+     * to the item's onError.
+     * @param item
+     * @return
+     */
+    bool verifyItem(const ServiceNodeVerifyItem & item) {
+        std::string err;
+        try {
+            if (item.isPing)
+                return item.ping.isValid(collateralTxFunc(), IsServiceNodeBlockValidFunc, item.skipValidation);
+            return item.snode.isValid(collateralTxFunc(), IsServiceNodeBlockValidFunc);
+        } catch (std::exception & e) {
+            err = e.what();
+        } catch (...) {
+            err = "unknown error";
+        }
+        LogPrint(BCLog::SNODE, "service node %s verified with error: %s\n",
+                 item.isPing ? "ping" : "registration", err);
+        if (item.onError)
+            item.onError(err);
+        return false;
+    }
+
+    /**
+     * Adds the verified ping or registration and notifies the caller.
+     * @param item
+     */
+    void applyItem(const ServiceNodeVerifyItem & item) {
+        if (!item.valid)
+            return;
+        // Callbacks run on the verification threads, an exception here must not escape the thread
+        try {
+            if (item.isPing) {
+                if (applyPing(item.ping) && item.onPing)
+                    item.onPing(item.ping);
+            } else {
+                auto snptr = addSn(item.snode, false); // already verified
+                if (snptr && item.onRegistration)
+                    item.onRegistration(*snptr);
+            }
+        } catch (std::exception & e) {
+            LogPrint(BCLog::SNODE, "service node %s processed with error: %s\n",
+                     item.isPing ? "ping" : "registration", e.what());
+        } catch (...) {
+            LogPrint(BCLog::SNODE, "service node %s processed with unknown error\n",
+                     item.isPing ? "ping" : "registration");
+        }
+    }
+
+    /**
+     * Hands the item to the verification threads. If no threads are running the item is
+     * processed on the calling thread. If the queue is full the item is verified on the
+     * calling thread and then applied in order with the items ahead of it.
+     * @param item
+     */
+    void queueVerify(const ServiceNodeVerifyItemPtr & item) {
+        bool inline_verify{false};
+        {
+            LOCK(verifyMu);
+            if (verifyThreads.empty() || stopVerify) {
+                inline_verify = true;
+            } else if (verifyPending.size() < MAX_SNODE_VERIFY_QUEUE) {
+                verifyOrdered.push_back(item);
+                verifyPending.push_back(item);
+                verifyCond.notify_one();
+                return;
+            }
+        }
+        if (inline_verify) {
+            item->valid = verifyItem(*item);
+            item->done = true;
+            applyItem(*item);
+            return;
+        }
+        item->valid = verifyItem(*item);
+        {
+            LOCK(verifyMu);
+            item->done = true;
+            verifyOrdered.push_back(item);
+        }
+        applyVerified();
+    }
+
+    /**
+     * Verification thread loop.
+     */
+    void verifyThread() {
+        while (true) {
+            ServiceNodeVerifyItemPtr item;
+            {
+                WAIT_LOCK(verifyMu, lock);
+                verifyCond.wait(lock, [this]() { return stopVerify || !verifyPending.empty(); });
+                if (stopVerify)
+                    return;
+                item = verifyPending.front();
+                verifyPending.pop_front();
+            }
+            const bool valid = verifyItem(*item);
+            {
+                LOCK(verifyMu);
+                item->valid = valid;
+                item->done = true;
+            }
+            applyVerified();
+        }
+    }
+
+    /**
+     * Applies verified items in the order they arrived. Stops at the first item that is
+     * still being verified, the thread verifying that item picks up from there.
+     */
+    void applyVerified() {
+        LOCK(applyMu);
+        while (true) {
+            ServiceNodeVerifyItemPtr item;
+            {
+                LOCK(verifyMu);
+                if (verifyOrdered.empty() || !verifyOrdered.front()->done) {
+                    if (verifyOrdered.empty())
+                        verifyDoneCond.notify_all();
+                    return;
+                }
+                item = verifyOrdered.front();
+                verifyOrdered.pop_front();
+            }
+            applyItem(*item);
+        }
+    }
+
+    /**
+     * Looks up the transaction for the collateral utxo. Unspent collateral is cached
+     * until a block spends it (see processValidationBlock), therefore repeat pings
+     * from the same snode avoid the disk read and coins lookup. A lookup that races
+     * with a block spending the collateral is not cached. Once the cache is full the
+     * least recently used collateral is evicted.
+     * @param out
+     * @param tx
+     * @return
+     */
+    bool getCollateralTx(const COutPoint & out, CTransactionRef & tx) {
+        uint64_t generation;
+        {
+            LOCK(collateralMu);
+            auto it = collateralTxs.find(out);
+            if (it != collateralTxs.end()) {
+                collateralLru.splice(collateralLru.begin(), collateralLru, it->second.lru);
+                tx = it->second.tx;
+                return true;
+            }
+            generation = collateralGeneration;
+        }
+        if (!GetTxFunc(out, tx))
+            return false; // only cache unspent collateral
+        LOCK(collateralMu);
+        if (generation != collateralGeneration)
+            return true; // cache was invalidated during the lookup, result may be stale
+        auto it = collateralTxs.find(out);
+        if (it != collateralTxs.end()) { // cached by a concurrent lookup
+            collateralLru.splice(collateralLru.begin(), collateralLru, it->second.lru);
+            it->second.tx = tx;
+            return true;
+        }
+        if (collateralTxs.size() >= MAX_COLLATERAL_CACHE) {
+            collateralTxs.erase(collateralLru.back());
+            collateralLru.pop_back();
+        }
+        collateralLru.push_front(out);
+        collateralTxs.emplace(out, CollateralEntry{tx, collateralLru.begin()});
+        return true;
+    }
+
+    /**
+     * Returns the cached collateral lookup used in servicenode validity checks.
+     * @return
+     */
+    TxFunc collateralTxFunc() {
+        return [this](const COutPoint & out, CTransactionRef & tx) -> bool {
+            return getCollateralTx(out, tx);
+        };
+    }
+
+    /**
+     * Removes the specified utxos from the collateral cache.
+     * @param spent
+     */
+    void uncacheCollateral(const std::set<COutPoint> & spent) {
+        LOCK(collateralMu);
+        ++collateralGeneration;
+        if (collateralTxs.empty())
+            return;
+        for (const auto & out : spent) {
+            auto it = collateralTxs.find(out);
+            if (it == collateralTxs.end())
+                continue;
+            collateralLru.erase(it->second.lru);
+            collateralTxs.erase(it);
+        }
+    }
+
     /**
      * Removes existing snodes that match the collateral utxos of
      * the specified snode. i.e. This method will mutate the snode
@@ -949,18 +1405,41 @@ protected:
      */
     void removeSnWithCollateral(const ServiceNode & snode) {
         LOCK(mu);
-        std::map<COutPoint, ServiceNodePtr> utxos;
-        for (const auto & item : snodes) {
-            const auto & s = item.second;
-            if (s->getSnodePubKey() != snode.getSnodePubKey()) { // exclude specified snode
-                for (const auto & utxo : s->getCollateral())
-                    utxos[utxo] = s;
-            }
-        }
         for (const auto & utxo : snode.getCollateral()) {
-            if (utxos.count(utxo) && snodes.count(utxos[utxo]->getSnodePubKey()))
-                snodes.erase(utxos[utxo]->getSnodePubKey());
+            auto it = collateralIndex.find(utxo);
+            if (it == collateralIndex.end() || it->second == snode.getSnodePubKey())
+                continue; // exclude specified snode
+            const CPubKey snodePubKey = it->second; // copy, eraseSn invalidates the iterator
+            eraseSn(snodePubKey);
+        }
+    }
+
+    /**
+     * Adds the servicenode to the list, replacing any existing snode with the
+     * same pubkey, and indexes its collateral utxos.
+     * @param snode
+     */
+    void insertSn(const ServiceNodePtr & snode) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        eraseSn(snode->getSnodePubKey());
+        snodes[snode->getSnodePubKey()] = snode;
+        for (const auto & utxo : snode->getCollateral())
+            collateralIndex[utxo] = snode->getSnodePubKey();
+    }
+
+    /**
+     * Removes the servicenode from the list along with its collateral index entries.
+     * @param snodePubKey
+     */
+    void eraseSn(const CPubKey & snodePubKey) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        auto it = snodes.find(snodePubKey);
+        if (it == snodes.end())
+            return;
+        for (const auto & utxo : it->second->getCollateral()) {
+            auto cit = collateralIndex.find(utxo);
+            if (cit != collateralIndex.end() && cit->second == snodePubKey)
+                collateralIndex.erase(cit);
         }
+        snodes.erase(it);
     }
 
 #ifdef ENABLE_WALLET
@@ -1183,7 +1662,7 @@ protected:
             if (snode.isNull())
                 continue; // skip snodes we don't know about
 
-            if (!snode.getInvalid() && snode.isValid(GetTxFunc, IsServiceNodeBlockValidFunc))
+            if (!snode.getInvalid() && snode.isValid(collateralTxFunc(), IsServiceNodeBlockValidFunc))
                 continue; // skip valid snodes
 
             // At this point we want to try and re-register any snodes that are marked
@@ -1224,21 +1703,27 @@ protected:
             }
         }
 
+        // Collateral spent (or orphaned) by this block must be looked up again
+        uncacheCollateral(spent);
+
         // Check that existing snodes are valid
         {
             LOCK(mu);
-            for (auto & item : snodes) {
-                auto snode = item.second;
-                for (const auto & collateral : snode->getCollateral()) {
-                    if (spent.count(collateral)) {
-                        snode->markInvalid(true, blockNumber);
-                        break;
-                    }
+            if (connected) {
+                for (const auto & out : spent) {
+                    auto it = collateralIndex.find(out);
+                    if (it == collateralIndex.end())
+                        continue;
+                    auto sit = snodes.find(it->second);
+                    if (sit != snodes.end())
+                        sit->second->markInvalid(true, blockNumber);
                 }
+            } else {
                 // Re-validate snodes on potential reorg (on block disconnected)
-                if (!connected) {
+                for (auto & item : snodes) {
+                    auto snode = item.second;
                     snode->markInvalid(false); // reset state before is valid check
-                    snode->markInvalid(!snode->isValid(GetTxFunc, IsServiceNodeBlockValidFunc));
+                    snode->markInvalid(!snode->isValid(collateralTxFunc(), IsServiceNodeBlockValidFunc));
                 }
             }
         }
@@ -1247,10 +1732,31 @@ protected:
 protected:
     Mutex mu;
     std::map<CPubKey, ServiceNodePtr> snodes;
+    std::unordered_map<COutPoint, CPubKey, SaltedOutpointHasher> collateralIndex; // collateral utxo -> snode pubkey
     std::unordered_map<CPubKey, ServiceNodePing, Hasher> pings;
-    std::set<uint256> seenPackets;
+    CRollingBloomFilter seenPackets{DEFAULT_SNODE_SEEN_PACKETS, SNODE_SEEN_PACKETS_FP_RATE};
     std::set<ServiceNodeConfigEntry> snodeEntries;
     std::vector<int> seenBlocks;
+
+    /** Max number of collateral utxos held by the collateral cache */
+    static const size_t MAX_COLLATERAL_CACHE = 50000;
+    Mutex collateralMu;
+    struct CollateralEntry {
+        CTransactionRef tx;
+        std::list<COutPoint>::iterator lru;
+    };
+    std::unordered_map<COutPoint, CollateralEntry, SaltedOutpointHasher> collateralTxs GUARDED_BY(collateralMu);
+    std::list<COutPoint> collateralLru GUARDED_BY(collateralMu); // most recently used first
+    uint64_t collateralGeneration GUARDED_BY(collateralMu){0}; // bumped when cached collateral is invalidated
+
+    Mutex applyMu; // serializes applying verified items, acquired before verifyMu
+    Mutex verifyMu;
+    std::condition_variable verifyCond;
+    std::condition_variable verifyDoneCond;
+    std::vector<std::thread> verifyThreads GUARDED_BY(verifyMu);
+    std::deque<ServiceNodeVerifyItemPtr> verifyPending GUARDED_BY(verifyMu); // waiting for a verification thread
+    std::deque<ServiceNodeVerifyItemPtr> verifyOrdered GUARDED_BY(verifyMu); // arrival order, waiting to be applied
+    bool stopVerify GUARDED_BY(verifyMu){false};
 };
 
 }
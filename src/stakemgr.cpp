@@ -19,6 +19,7 @@ void ThreadStakeMinter() {
     RenameThread("blocknet-staker");
     LogPrintf("Staker has started\n");
     g_staker = MakeUnique<StakeMgr>();
+    g_staker->TrackStakeOutputs();
     const auto stakingSkipPeers = gArgs.GetBoolArg("-stakingwithoutpeers", false);
     const auto & chainparams = Params();
     int64_t lastTime{0};
@@ -55,8 +56,7 @@ void ThreadStakeMinter() {
         } catch (...) { }
         boost::this_thread::sleep_for(boost::chrono::seconds(1));
     }
-    g_staker.reset();
-    LogPrintf("Staker shutdown\n");
+    LogPrintf("Staker shutdown\n"); // g_staker is destroyed on shutdown once the scheduler thread stopped
 }
 
 bool StakeMgr::Update(std::vector<std::shared_ptr<CWallet>> & wallets, const CBlockIndex *tip, const Consensus::Params & params, const bool & skipPeerRequirement) {
@@ -90,10 +90,23 @@ bool StakeMgr::Update(std::vector<std::shared_ptr<CWallet>> & wallets, const CBl
     const auto minStakeAmount = argStakeAmount == 0 ? 1 : argStakeAmount * COIN;
     const auto tipHeight = tip->nHeight;
 
+    if (stakeOutputs)
+        stakeOutputs->Prune(wallets);
+
     for (const auto & pwallet : wallets) {
-        const std::vector<COutput> & coins = StakeOutputs(pwallet.get(), minStakeAmount);
+        std::vector<COutput> coins;
+        // Prefer the incrementally tracked outputs, fallback to a full wallet scan (which
+        // also reseeds the tracked outputs) if they're not synced with the tip.
+        if (!stakeOutputs || !stakeOutputs->Outputs(pwallet.get(), tip, minStakeAmount, coins)) {
+            const CBlockIndex *scanTip = nullptr;
+            coins = StakeOutputs(pwallet.get(), 1, &scanTip);
+            if (stakeOutputs && scanTip)
+                stakeOutputs->Reset(pwallet.get(), coins, scanTip);
+        }
         // Find suitable staking coins
         for (const COutput & out : coins) {
+            if (out.tx->tx->vout[out.i].nValue < minStakeAmount)
+                continue;
             if (SuitableCoin(out, tipHeight, params))
                 selected.emplace_back(std::make_shared<COutput>(out), pwallet);
         }
@@ -102,26 +115,58 @@ bool StakeMgr::Update(std::vector<std::shared_ptr<CWallet>> & wallets, const CBl
     // Always search for stake from last block time if the tip changed
     lastUpdateTime = tipChanged ? tip->GetBlockTime() + 1 : lastUpdateTime + 1;
 
-    // Cache all possible stakes between last update and few seconds into the future
-    for (const auto & item : selected) {
-        boost::this_thread::interruption_point();
-        const auto out = item.out;
-        auto wallet = item.wallet;
-        std::map<int64_t, std::vector<StakeCoin>> stakes;
-        adjustedTime = GetAdjustedTime(); // update here b/c this loop could be long running process
-        const auto blockTime = std::max(tip->GetBlockTime()+1, adjustedTime);
-        endTime = blockTime + params.PoSFutureBlockTimeLimit(blockTime); // current time + seconds into future
-        if (!GetStakesMeetingTarget(out, wallet, tip, adjustedTime, blockTime, lastUpdateTime, endTime, stakes, params))
-            continue;
-        if (!stakes.empty()) {
-            LOCK(mu);
-            stakeTimes.insert(stakes.begin(), stakes.end());
+    // Cache all possible stakes between last update and few seconds into the future. Coins are
+    // searched by the staker's pool of search threads that pull the next unclaimed chunk of coins
+    // from a shared cursor, idle threads pick up the remaining work of slower ones. Each coin
+    // collects its stakes into its own slot so that the results can be merged in selection order.
+    if (!searchPool)
+        searchPool = MakeUnique<StakeSearchPool>(StakingThreads());
+    const auto searchFrom = lastUpdateTime.load();
+    std::atomic<size_t> nextCoin{0};
+    std::atomic<bool> stop{false};
+    std::vector<std::map<int64_t, std::vector<StakeCoin>>> coinStakes(selected.size());
+    std::vector<int64_t> threadEndTimes(searchPool->Size(), endTime);
+
+    auto searchCoins = [&](const int id) {
+        try {
+            while (!stop) {
+                const size_t from = nextCoin.fetch_add(STAKING_CHUNK);
+                if (from >= selected.size())
+                    break;
+                const size_t to = std::min(from + STAKING_CHUNK, selected.size());
+                for (size_t i = from; i < to && !stop; ++i) {
+                    boost::this_thread::interruption_point();
+                    const auto & item = selected[i];
+                    auto wallet = item.wallet;
+                    const auto coinAdjustedTime = GetAdjustedTime(); // update here b/c this loop could be long running process
+                    const auto blockTime = std::max(tip->GetBlockTime()+1, coinAdjustedTime);
+                    threadEndTimes[id] = blockTime + params.PoSFutureBlockTimeLimit(blockTime); // current time + seconds into future
+                    GetStakesMeetingTarget(item.out, wallet, tip, coinAdjustedTime, blockTime, searchFrom, threadEndTimes[id], coinStakes[i], params);
+                }
+            }
+        } catch (...) {
+            stop = true; // stop the other search threads, the failure is rethrown on the staker thread
+            throw;
         }
+    };
+
+    if (selected.size() <= STAKING_CHUNK)
+        searchCoins(0); // not worth waking up the search threads
+    else
+        searchPool->Run(searchCoins);
+
+    {
+        LOCK(mu);
+        // Same as the serial search, the first coin (in selection order) found for a stake time is kept
+        for (auto & stakes : coinStakes)
+            stakeTimes.insert(stakes.begin(), stakes.end());
     }
+    endTime = *std::max_element(threadEndTimes.begin(), threadEndTimes.end());
 
     lastBlockHeight = tipHeight;
     lastUpdateTime = endTime;
     LogPrint(BCLog::STAKE, "Staker: %u\n", lastBlockHeight);
+    LOCK(mu);
     return !stakeTimes.empty();
 }
 
@@ -212,6 +257,20 @@ bool StakeMgr::StakeBlock(const StakeCoin & stakeCoin, const CChainParams & chai
     return fNewBlock;
 }
 
+void StakeMgr::TrackStakeOutputs() {
+    if (stakeOutputs)
+        return;
+    stakeOutputs = MakeUnique<StakeOutputCache>();
+    RegisterValidationInterface(stakeOutputs.get());
+}
+
+int StakeMgr::StakingThreads() {
+    int threads = static_cast<int>(gArgs.GetArg("-stakingthreads", DEFAULT_STAKING_THREADS));
+    if (threads <= 0)
+        threads += GetNumCores();
+    return std::max(1, std::min(threads, MAX_STAKING_THREADS));
+}
+
 int64_t StakeMgr::LastUpdateTime() const {
     return lastUpdateTime;
 }
@@ -240,7 +299,7 @@ bool StakeMgr::SuitableCoin(const COutput & coin, const int & tipHeight, const C
     return true;
 }
 
-std::vector<COutput> StakeMgr::StakeOutputs(CWallet *wallet, const CAmount & minStakeAmount) const {
+std::vector<COutput> StakeMgr::StakeOutputs(CWallet *wallet, const CAmount & minStakeAmount, const CBlockIndex **scanTip) const {
     std::vector<COutput> coins; // all confirmed coins
     auto locked_chain = wallet->chain().lock();
     LOCK2(cs_main, wallet->cs_wallet);
@@ -251,6 +310,8 @@ std::vector<COutput> StakeMgr::StakeOutputs(CWallet *wallet, const CAmount & min
         return coins; // skip locked wallets
     }
     wallet->AvailableCoins(*locked_chain, coins, true, nullptr, minStakeAmount, MAX_MONEY, MAX_MONEY, 0);
+    if (scanTip)
+        *scanTip = chainActive.Tip();
     return coins;
 }
 
@@ -276,42 +337,30 @@ bool StakeMgr::GetStakesMeetingTarget(const std::shared_ptr<COutput> & coin, std
 
     arith_uint256 bnTargetPerCoinDay;
     bnTargetPerCoinDay.SetCompact(tip->nBits);
+    const auto nValueIn = coin->GetInputCoin().txout.nValue;
+    const auto minTime = txTime + params.stakeMinAge; // skip times where coin doesn't meet stake age
+    int64_t kernelTime{0};
+    uint256 hashProofOfStake;
 
     if (IsProtocolV05(fromTime)) { // Protocol v5+
         if (blockTime - params.stakeMinAge <= hashBlockTime) // valid modifier time check
             return false;
+        if (std::max(fromTime, minTime) >= toTime)
+            return true;
 
-        int64_t i = fromTime;
-        for (; i < toTime; ++i) {
-            if (i - txTime < params.stakeMinAge)
-                continue; // skip coins that don't meet stake age
-            uint64_t stakeModifier{0};
-            int stakeModifierHeight{0};
-            int64_t stakeModifierTime{0};
-            if (!GetKernelStakeModifier(tip, pindexStake, blockTime, stakeModifier, stakeModifierHeight, stakeModifierTime))
-                continue;
-
-            CDataStream ss(SER_GETHASH, 0);
-            ss << stakeModifier;
+        uint64_t stakeModifier{0};
+        int stakeModifierHeight{0};
+        int64_t stakeModifierTime{0};
+        if (!GetKernelStakeModifier(tip, pindexStake, blockTime, stakeModifier, stakeModifierHeight, stakeModifierTime))
+            return true;
 
-            uint256 hashProofOfStake;
-            if (IsProtocolV07(blockTime, params)) {
-                hashProofOfStake = stakeHashV06(ss, txInBlockHash, hashBlockTime, stakeHeight, coin->i, i);
-                if (!stakeTargetHitV07(hashProofOfStake, i, tip->nNonce, coin->GetInputCoin().txout.nValue, bnTargetPerCoinDay, params.nPowTargetSpacing))
-                    continue;
-            } else if (IsProtocolV06(blockTime, params)) {
-                hashProofOfStake = stakeHashV06(ss, txInBlockHash, hashBlockTime, stakeHeight, coin->i, i);
-                if (!stakeTargetHitV06(hashProofOfStake, coin->GetInputCoin().txout.nValue, bnTargetPerCoinDay))
-                    continue;
-            } else {
-                hashProofOfStake = stakeHashV05(ss, hashBlockTime, stakeHeight, coin->i, i);
-                if (!stakeTargetHit(hashProofOfStake, coin->GetInputCoin().txout.nValue, bnTargetPerCoinDay))
-                    continue;
-            }
-            stakes[i].emplace_back(std::make_shared<CInputCoin>(coin->GetInputCoin()), wallet, i,
+        const auto hasher = IsProtocolV07(blockTime, params) || IsProtocolV06(blockTime, params)
+                ? StakeKernelHasher::V06(stakeModifier, txInBlockHash, hashBlockTime, stakeHeight, coin->i)
+                : StakeKernelHasher::V05(stakeModifier, hashBlockTime, stakeHeight, coin->i);
+        StakeKernelTarget target(blockTime, tip->nNonce, nValueIn, bnTargetPerCoinDay, params);
+        if (FindStakeKernel(hasher, target, fromTime, toTime, minTime, kernelTime, hashProofOfStake))
+            stakes[kernelTime].emplace_back(std::make_shared<CInputCoin>(coin->GetInputCoin()), wallet, kernelTime,
                     blockTime, txInBlockHash, hashBlockTime, hashProofOfStake);
-            break;
-        }
     } else {
         uint64_t stakeModifier = HasStakeModifier(txInBlockHash) ? GetStakeModifier(txInBlockHash) : 0;
         int stakeModifierHeight{0};
@@ -323,20 +372,11 @@ bool StakeMgr::GetStakesMeetingTarget(const std::shared_ptr<COutput> & coin, std
         if (!HasStakeModifier(txInBlockHash))
             UpdateStakeModifier(txInBlockHash, stakeModifier);
 
-        CDataStream ss(SER_GETHASH, 0);
-        ss << stakeModifier;
-
-        int64_t i = fromTime;
-        for (; i < toTime; ++i) {
-            if (i - txTime < params.stakeMinAge) // skip coins that don't meet stake age
-                continue;
-            const auto hashProofOfStake = stakeHash(i, ss, coin->i, coin->tx->GetHash(), hashBlockTime);
-            if (!stakeTargetHit(hashProofOfStake, coin->GetInputCoin().txout.nValue, bnTargetPerCoinDay))
-                continue;
-            stakes[i].emplace_back(std::make_shared<CInputCoin>(coin->GetInputCoin()), wallet, i, 0,
-                                       coin->tx->hashBlock, hashBlockTime, hashProofOfStake);
-            break;
-        }
+        const auto hasher = StakeKernelHasher::V03(stakeModifier, hashBlockTime, coin->i, coin->tx->GetHash());
+        StakeKernelTarget target(0, tip->nNonce, nValueIn, bnTargetPerCoinDay, params); // legacy target
+        if (FindStakeKernel(hasher, target, fromTime, toTime, minTime, kernelTime, hashProofOfStake))
+            stakes[kernelTime].emplace_back(std::make_shared<CInputCoin>(coin->GetInputCoin()), wallet, kernelTime, 0,
+                                            coin->tx->hashBlock, hashBlockTime, hashProofOfStake);
     }
 
     return true;
@@ -350,4 +390,255 @@ void StakeMgr::Reset() {
     }
     lastUpdateTime = 0;
     lastBlockHeight = 0;
+}
+
+StakeSearchPool::StakeSearchPool(const int threads) {
+    for (int i = 1; i < threads; ++i) {
+        this->threads.emplace_back([this,i]() {
+            RenameThread("blocknet-stakesearch");
+            Worker(i);
+        });
+    }
+}
+
+StakeSearchPool::~StakeSearchPool() {
+    {
+        LOCK(mu);
+        stopped = true;
+    }
+    cond.notify_all();
+    for (auto & t : threads) {
+        if (t.joinable())
+            t.join();
+    }
+}
+
+int StakeSearchPool::Size() const {
+    return static_cast<int>(threads.size()) + 1;
+}
+
+void StakeSearchPool::Run(const std::function<void(int)> & job) {
+    {
+        LOCK(mu);
+        this->job = &job;
+        running = static_cast<int>(threads.size());
+        error = nullptr;
+        ++generation;
+    }
+    cond.notify_all();
+
+    std::exception_ptr callerError;
+    try {
+        job(0);
+    } catch (...) {
+        callerError = std::current_exception();
+    }
+
+    // The job refers to the caller's stack, wait for all workers even if the caller failed
+    WAIT_LOCK(mu, lock);
+    doneCond.wait(lock, [this]() { return running == 0; });
+    this->job = nullptr;
+    if (callerError)
+        std::rethrow_exception(callerError);
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void StakeSearchPool::Worker(const int id) {
+    uint64_t lastGeneration{0};
+    while (true) {
+        const std::function<void(int)> *work{nullptr};
+        {
+            WAIT_LOCK(mu, lock);
+            cond.wait(lock, [this,lastGeneration]() { return stopped || generation != lastGeneration; });
+            if (stopped)
+                return;
+            lastGeneration = generation;
+            work = job;
+        }
+        std::exception_ptr workError;
+        try {
+            (*work)(id);
+        } catch (...) {
+            workError = std::current_exception();
+        }
+        {
+            LOCK(mu);
+            if (workError && !error)
+                error = workError;
+            --running;
+        }
+        doneCond.notify_all();
+    }
+}
+
+StakeOutputCache::~StakeOutputCache() {
+    UnregisterValidationInterface(this);
+    LOCK(mu);
+    for (auto & item : walletOutputs)
+        item.second.statusChanged.disconnect();
+}
+
+bool StakeOutputCache::Outputs(CWallet *wallet, const CBlockIndex *tip, const CAmount & minStakeAmount, std::vector<COutput> & coins) {
+    LOCK2(wallet->cs_wallet, mu);
+    if (wallet->IsLocked()) {
+        static int stakelog{-1};
+        if (++stakelog % 10 == 0)
+            LogPrintf("Wallet is locked not staking inputs: %s\n", wallet->GetDisplayName());
+        return true; // skip locked wallets
+    }
+    auto it = walletOutputs.find(wallet);
+    if (it == walletOutputs.end())
+        return false;
+    const auto & w = it->second;
+    if (w.dirty || w.name != wallet->GetName() || w.bestBlock != tip->GetBlockHash() || GetTime() - w.updated >= STAKE_OUTPUTS_RESYNC)
+        return false;
+
+    const auto coinMaturity = Params().GetConsensus().coinMaturity;
+    coins.reserve(w.outputs.size());
+    for (const auto & item : w.outputs) {
+        const auto & out = item.second;
+        const auto *wtx = wallet->GetWalletTx(item.first.hash);
+        if (!wtx || item.first.n >= wtx->tx->vout.size()) {
+            coins.clear();
+            return false; // wallet transactions changed (e.g. zapped), rescan
+        }
+        if (wtx->tx->vout[item.first.n].nValue < minStakeAmount)
+            continue;
+        if (mempoolSpends.count(item.first) || wallet->IsLockedCoin(item.first.hash, item.first.n))
+            continue;
+        const int depth = tip->nHeight - out.height + 1;
+        if ((wtx->IsCoinBase() || wtx->IsCoinStake()) && depth < coinMaturity + 1)
+            continue; // immature
+        // Spend size is cached from the wallet scan, avoid recomputing the dummy signature per output
+        COutput coin(wtx, item.first.n, depth, false, out.fSolvable, true);
+        coin.fSpendable = true;
+        coin.nInputBytes = out.nInputBytes;
+        coins.push_back(coin);
+    }
+    return true;
+}
+
+void StakeOutputCache::Reset(CWallet *wallet, const std::vector<COutput> & coins, const CBlockIndex *scanTip) {
+    LOCK(mu);
+    auto & w = walletOutputs[wallet];
+    if (w.name != wallet->GetName()) {
+        w.statusChanged.disconnect();
+        w.statusChanged = wallet->NotifyStatusChanged.connect([this,wallet](CCryptoKeyStore*) {
+            // Locked wallets are not scanned, rescan outputs once unlocked
+            LOCK(mu);
+            auto it = walletOutputs.find(wallet);
+            if (it != walletOutputs.end())
+                it->second.dirty = true;
+        });
+        w.name = wallet->GetName();
+    }
+    w.outputs.clear();
+    for (const auto & coin : coins) {
+        if (!coin.fSpendable)
+            continue;
+        const COutPoint outpoint(coin.tx->GetHash(), coin.i);
+        w.outputs[outpoint] = {scanTip->nHeight - coin.nDepth + 1, coin.nInputBytes, coin.fSolvable};
+    }
+    w.bestBlock = scanTip->GetBlockHash();
+    w.updated = GetTime();
+    w.dirty = false;
+}
+
+void StakeOutputCache::Prune(const std::vector<std::shared_ptr<CWallet>> & wallets) {
+    LOCK(mu);
+    for (auto it = walletOutputs.begin(); it != walletOutputs.end(); ) {
+        const bool loaded = std::find_if(wallets.begin(), wallets.end(), [&it](const std::shared_ptr<CWallet> & wallet) {
+            return wallet.get() == it->first && wallet->GetName() == it->second.name;
+        }) != wallets.end();
+        if (loaded) {
+            ++it;
+            continue;
+        }
+        it->second.statusChanged.disconnect();
+        it = walletOutputs.erase(it);
+    }
+}
+
+void StakeOutputCache::AddOutputs(CWallet *wallet, WalletOutputs & w, const CTransactionRef & tx, const int & height) {
+    const CWalletTx *wtx = nullptr;
+    for (unsigned int i = 0; i < tx->vout.size(); ++i) {
+        const auto & txout = tx->vout[i];
+        if (txout.nValue <= 0 || !(wallet->IsMine(txout) & ISMINE_SPENDABLE))
+            continue;
+        if (!wtx)
+            wtx = wallet->GetWalletTx(tx->GetHash());
+        if (!wtx) { // wallet hasn't processed the transaction yet
+            w.dirty = true;
+            return;
+        }
+        const COutput coin(wtx, i, 1, true, IsSolvable(*wallet, txout.scriptPubKey), true);
+        w.outputs[{tx->GetHash(), i}] = {height, coin.nInputBytes, coin.fSolvable};
+    }
+}
+
+void StakeOutputCache::SetDirty() {
+    LOCK(mu);
+    for (auto & item : walletOutputs)
+        item.second.dirty = true;
+}
+
+void StakeOutputCache::TransactionAddedToMempool(const CTransactionRef & tx) {
+    for (const auto & pwallet : GetWallets()) {
+        LOCK2(pwallet->cs_wallet, mu);
+        if (!walletOutputs.count(pwallet.get()))
+            continue;
+        auto & w = walletOutputs[pwallet.get()];
+        for (const auto & txin : tx->vin) {
+            if (w.outputs.erase(txin.prevout) || pwallet->IsMine(txin) != ISMINE_NO)
+                mempoolSpends.insert(txin.prevout);
+        }
+    }
+}
+
+void StakeOutputCache::TransactionRemovedFromMempool(const CTransactionRef & tx) {
+    LOCK(mu);
+    bool spent{false};
+    for (const auto & txin : tx->vin)
+        spent = mempoolSpends.erase(txin.prevout) || spent;
+    if (!spent)
+        return;
+    // Outputs spent by the evicted transaction are stakeable again
+    for (auto & item : walletOutputs)
+        item.second.dirty = true;
+}
+
+void StakeOutputCache::BlockConnected(const std::shared_ptr<const CBlock> & block, const CBlockIndex *pindex,
+                                      const std::vector<CTransactionRef> & txnConflicted)
+{
+    if (!txnConflicted.empty())
+        SetDirty(); // conflicted transactions may have spent wallet outputs
+    for (const auto & pwallet : GetWallets()) {
+        LOCK2(pwallet->cs_wallet, mu);
+        auto it = walletOutputs.find(pwallet.get());
+        if (it == walletOutputs.end())
+            continue;
+        auto & w = it->second;
+        if (w.bestBlock == pindex->GetBlockHash())
+            continue; // already included by the last wallet scan
+        if (!pindex->pprev || w.bestBlock != pindex->pprev->GetBlockHash())
+            w.dirty = true; // missed a block, rescan
+        if (w.dirty)
+            continue;
+        for (const auto & tx : block->vtx) {
+            for (const auto & txin : tx->vin)
+                w.outputs.erase(txin.prevout);
+            AddOutputs(pwallet.get(), w, tx, pindex->nHeight);
+        }
+        w.bestBlock = pindex->GetBlockHash();
+    }
+    LOCK(mu);
+    for (const auto & tx : block->vtx) {
+        for (const auto & txin : tx->vin)
+            mempoolSpends.erase(txin.prevout);
+    }
+}
+
+void StakeOutputCache::BlockDisconnected(const std::shared_ptr<const CBlock> & block) {
+    SetDirty(); // outputs spent by the disconnected block are restored by a rescan
 }
\ No newline at end of file
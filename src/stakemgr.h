@@ -8,13 +8,117 @@
 
 #include <chainparams.h>
 #include <consensus/params.h>
+#include <coins.h>
 #include <keystore.h>
+#include <validationinterface.h>
 #include <wallet/coinselection.h>
 #include <wallet/wallet.h>
 
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <thread>
+
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/thread.hpp>
 
+//! -stakingthreads default (0 = auto, one per core)
+static const int DEFAULT_STAKING_THREADS = 0;
+//! Maximum number of stake search threads
+static const int MAX_STAKING_THREADS = 16;
+//! Number of coins a stake search thread claims at a time
+static const size_t STAKING_CHUNK = 16;
+//! Seconds after which tracked stake outputs are rescanned from the wallet (covers rescans and imports)
+static const int64_t STAKE_OUTPUTS_RESYNC = 600;
+
+/**
+ * Stakeable wallet outputs maintained incrementally from validation notifications.
+ * Each wallet is seeded with a full wallet scan, afterwards outputs are added and
+ * removed as blocks connect and mempool transactions spend them. A wallet is flagged
+ * for a rescan whenever its outputs can't be updated incrementally (disconnected
+ * blocks, mempool evictions, missed blocks, unlocks). Only outpoints are tracked,
+ * the wallet transactions are looked up under cs_wallet when the outputs are read.
+ */
+class StakeOutputCache final : public CValidationInterface {
+public:
+    /**
+     * Unregisters from the validation interface. Callbacks already running on the
+     * scheduler thread are not waited on, destroy the cache after
+     * SyncWithValidationInterfaceQueue() or after the scheduler thread stopped.
+     */
+    ~StakeOutputCache();
+    /**
+     * Stakeable outputs for the wallet at the specified tip. Does not require cs_main.
+     * Returns false if the wallet is not synced to the tip and requires a rescan.
+     */
+    bool Outputs(CWallet *wallet, const CBlockIndex *tip, const CAmount & minStakeAmount, std::vector<COutput> & coins);
+    /** Seed the wallet's outputs from a full wallet scan performed at scanTip. */
+    void Reset(CWallet *wallet, const std::vector<COutput> & coins, const CBlockIndex *scanTip);
+    /** Drop state for wallets that are no longer loaded. */
+    void Prune(const std::vector<std::shared_ptr<CWallet>> & wallets);
+
+protected:
+    void TransactionAddedToMempool(const CTransactionRef & tx) override;
+    void TransactionRemovedFromMempool(const CTransactionRef & tx) override;
+    void BlockConnected(const std::shared_ptr<const CBlock> & block, const CBlockIndex *pindex,
+                        const std::vector<CTransactionRef> & txnConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock> & block) override;
+
+private:
+    struct Output {
+        int height;
+        int nInputBytes;
+        bool fSolvable;
+    };
+    struct WalletOutputs {
+        std::string name;
+        std::unordered_map<COutPoint, Output, SaltedOutpointHasher> outputs;
+        uint256 bestBlock;
+        int64_t updated{0};
+        bool dirty{true};
+        boost::signals2::connection statusChanged;
+    };
+    void AddOutputs(CWallet *wallet, WalletOutputs & w, const CTransactionRef & tx, const int & height);
+    void SetDirty();
+
+private:
+    Mutex mu;
+    std::map<CWallet*, WalletOutputs> walletOutputs;
+    std::set<COutPoint> mempoolSpends; // wallet outputs spent by mempool transactions
+};
+
+/**
+ * Stake search threads kept for the lifetime of the staker. Run() hands the same
+ * job to the calling thread and every worker thread and returns once all of them
+ * are done.
+ */
+class StakeSearchPool {
+public:
+    explicit StakeSearchPool(int threads);
+    ~StakeSearchPool();
+    /** Number of threads running a job, including the calling thread. */
+    int Size() const;
+    /**
+     * Runs job(0) on the calling thread and job(1) .. job(Size()-1) on the worker threads.
+     * Waits for all of them, an exception thrown by any of them is rethrown here.
+     */
+    void Run(const std::function<void(int)> & job);
+
+private:
+    void Worker(int id);
+
+private:
+    Mutex mu;
+    std::condition_variable cond;
+    std::condition_variable doneCond;
+    std::vector<std::thread> threads;
+    const std::function<void(int)> *job GUARDED_BY(mu){nullptr};
+    uint64_t generation GUARDED_BY(mu){0};
+    int running GUARDED_BY(mu){0};
+    std::exception_ptr error GUARDED_BY(mu);
+    bool stopped GUARDED_BY(mu){false};
+};
+
 class StakeMgr {
 public:
     struct StakeCoin {
@@ -85,11 +189,13 @@ public:
     int LastBlockHeight() const;
     const StakeCoin & GetStake();
     bool SuitableCoin(const COutput & coin, const int & tipHeight, const Consensus::Params & params) const;
-    std::vector<COutput> StakeOutputs(CWallet *wallet, const CAmount & minStakeAmount) const;
+    std::vector<COutput> StakeOutputs(CWallet *wallet, const CAmount & minStakeAmount, const CBlockIndex **scanTip=nullptr) const;
     bool GetStakesMeetingTarget(const std::shared_ptr<COutput> & coin, std::shared_ptr<CWallet> & wallet,
         const CBlockIndex *tip, const int64_t & adjustedTime, const int64_t & blockTime, const int64_t & fromTime,
         const int64_t & toTime, std::map<int64_t, std::vector<StakeCoin>> & stakes, const Consensus::Params & params);
     void Reset();
+    void TrackStakeOutputs();
+    static int StakingThreads();
 
 private:
     bool HasStakeModifier(const uint256 & blockHash) {
@@ -111,6 +217,8 @@ private:
     std::map<uint256, uint64_t> stakeModifiers;
     std::atomic<int64_t> lastUpdateTime{0};
     std::atomic<int> lastBlockHeight{0};
+    std::unique_ptr<StakeOutputCache> stakeOutputs;
+    std::unique_ptr<StakeSearchPool> searchPool;
 };
 
 extern void ThreadStakeMinter();
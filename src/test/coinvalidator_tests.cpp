@@ -0,0 +1,31 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coinvalidator.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(coinvalidator_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(coinvalidator_lookups)
+{
+    const std::string infraction = "00c0a0a887c2663e563494bd87f0ce279698d3e4f60fa3c5c39893f7fce8c336";
+    auto & validator = CoinValidator::instance();
+    validator.Clear();
+    BOOST_CHECK(validator.IsCoinValid(uint256S(infraction))); // nothing loaded
+
+    validator.LoadStatic();
+    BOOST_CHECK(validator.IsLoaded());
+    BOOST_CHECK(!validator.IsCoinValid(uint256S(infraction)));
+    BOOST_CHECK(!validator.IsCoinValid(infraction));
+    BOOST_CHECK(!validator.GetInfractions(uint256S(infraction)).empty());
+    BOOST_CHECK(validator.IsCoinValid(InsecureRand256()));
+    BOOST_CHECK(validator.IsCoinValid(std::string("not a txid")));
+
+    validator.Clear();
+    BOOST_CHECK(validator.IsCoinValid(uint256S(infraction)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1756,6 +1756,7 @@ BOOST_FIXTURE_TEST_CASE(governance_tests_vote_limits, TestChainPoS)
         BOOST_CHECK_MESSAGE(txnsOther.size() == 1, strprintf("Expected 1 transaction, instead have %d on tally test", txnsOther.size()));
         StakeBlocks(1), SyncWithValidationInterfaceQueue();
         auto tallyOther = gov::Governance::getTally(proposal.getHash(), gov::Governance::instance().getVotes(), consensus);
+        BOOST_CHECK_MESSAGE(gov::Governance::instance().getTally(proposal.getHash(), consensus) == tallyOther, "Cached tally should match the calculated tally");
         BOOST_CHECK_EQUAL(tallyOther.yes, 1);
         BOOST_CHECK_EQUAL(tallyOther.no, 0);
         BOOST_CHECK_EQUAL(tallyOther.abstain, 0);
@@ -1772,6 +1773,14 @@ BOOST_FIXTURE_TEST_CASE(governance_tests_vote_limits, TestChainPoS)
         BOOST_CHECK_MESSAGE(txns.size() == 3, strprintf("Expected %d transactions, instead have %d on tally test", 3, txns.size()));
         StakeBlocks(1), SyncWithValidationInterfaceQueue();
         auto tally = gov::Governance::getTally(proposal.getHash(), gov::Governance::instance().getVotes(), consensus);
+        BOOST_CHECK_MESSAGE(gov::Governance::instance().getTally(proposal.getHash(), consensus) == tally, "Cached tally should be updated after new votes");
+        {
+            const auto allVotes = gov::Governance::instance().getVotes();
+            const auto proposalVotes = std::count_if(allVotes.begin(), allVotes.end(), [&proposal](const gov::Vote & vote) {
+                return vote.getProposal() == proposal.getHash() && !vote.spent();
+            });
+            BOOST_CHECK_EQUAL(gov::Governance::instance().getVotes(proposal.getHash()).size(), static_cast<size_t>(proposalVotes));
+        }
         CBlock block;
         BOOST_CHECK(ReadBlockFromDisk(block, chainActive.Tip(), consensus));
         std::set<gov::Proposal> ps;
@@ -2089,6 +2098,13 @@ BOOST_AUTO_TEST_CASE(governance_tests_superblockresults)
                 const auto & tally = gov::Governance::getTally(cv.proposal.getHash(), allVotesB, consensus);
                 BOOST_CHECK_MESSAGE(tally.no == maxVotes, strprintf("Expected %d no votes on the changed votes test, instead found %d", maxVotes, tally.no));
             }
+            // Cached superblock results must reflect the changed votes
+            const auto results = gov::Governance::instance().getSuperblockResults(gov::NextSuperblock(consensus), consensus, true);
+            for (const auto & cv : castVotes) {
+                BOOST_CHECK(results.count(cv.proposal));
+                if (results.count(cv.proposal))
+                    BOOST_CHECK_EQUAL(results.at(cv.proposal).no, maxVotes);
+            }
         }
 
         // Vote invalidation tests
@@ -3127,7 +3143,31 @@ BOOST_AUTO_TEST_CASE(governance_tests_loadgovernancedata_votes)
         // Stop watching for on-chain gov data in preparation for testing the load funcs below
         UnregisterValidationInterface(&gov::Governance::instance());
 
+        // The state above was built by processing each block as it connected, the
+        // serial replay path. Every load below must match its votes and tallies.
+        std::set<uint256> baselineVotes;
+        for (const auto & vote : cvs)
+            baselineVotes.insert(vote.getHash());
+        std::map<uint256, gov::Tally> baselineTallies;
+        for (const auto & proposal : cps)
+            baselineTallies[proposal.getHash()] = gov::Governance::getTally(proposal.getHash(), cvs, consensus);
+        auto checkBaseline = [&baselineVotes,&baselineTallies,&consensus](const std::string & load) {
+            const auto votes = gov::Governance::instance().getVotes();
+            std::set<uint256> loaded;
+            for (const auto & vote : votes)
+                loaded.insert(vote.getHash());
+            BOOST_CHECK_MESSAGE(loaded == baselineVotes, strprintf("Votes from the %s load should match the serial replay", load));
+            for (const auto & item : baselineTallies) {
+                BOOST_CHECK_MESSAGE(gov::Governance::getTally(item.first, votes, consensus) == item.second,
+                                    strprintf("Tally from the %s load should match the serial replay for %s", load, item.first.ToString()));
+                BOOST_CHECK_MESSAGE(gov::Governance::instance().getTally(item.first, consensus) == item.second,
+                                    strprintf("Cached tally from the %s load should match the serial replay for %s", load, item.first.ToString()));
+            }
+        };
+
         // Load governance data with single thread
+        std::unordered_map<uint256, gov::Proposal, gov::Hasher> serialProposals;
+        std::unordered_map<uint256, gov::Vote, gov::Hasher> serialVotes;
         {
             gov::Governance::instance().reset();
             failReason.clear();
@@ -3142,6 +3182,38 @@ BOOST_AUTO_TEST_CASE(governance_tests_loadgovernancedata_votes)
                                                                       "expected %u, spent or invalid %u", gvotes.size(), expecting, spent));
             BOOST_CHECK_MESSAGE(gvotes.size() == cvs.size(), strprintf("Failed to load governance data votes, found %u "
                                                                       "expected %u, spent or invalid %u", gvotes.size(), cvs.size(), spent));
+            serialProposals = gov::Governance::instance().copyProposals();
+            serialVotes = gov::Governance::instance().copyVotes();
+            checkBaseline("single threaded");
+        }
+
+        // Load governance data with multiple threads, state must match the single threaded load
+        {
+            gov::Governance::instance().reset();
+            failReason.clear();
+            auto govsuccess = gov::Governance::instance().loadGovernanceData(chainActive, cs_main, consensus, failReason, 4);
+            BOOST_CHECK_MESSAGE(govsuccess, strprintf("Failed to load governance data from the chain via 4 threads: %s", failReason));
+            BOOST_CHECK_MESSAGE(failReason.empty(), "loadGovernanceData fail reason should be empty");
+            const auto pproposals = gov::Governance::instance().copyProposals();
+            const auto pvotes = gov::Governance::instance().copyVotes();
+            BOOST_CHECK_EQUAL(pproposals.size(), serialProposals.size());
+            BOOST_CHECK_EQUAL(pvotes.size(), serialVotes.size());
+            for (const auto & item : serialProposals)
+                BOOST_CHECK_MESSAGE(pproposals.count(item.first), strprintf("Proposal %s missing from parallel load", item.first.ToString()));
+            for (const auto & item : serialVotes) {
+                const auto it = pvotes.find(item.first);
+                BOOST_CHECK_MESSAGE(it != pvotes.end(), strprintf("Vote %s missing from parallel load", item.first.ToString()));
+                if (it == pvotes.end())
+                    continue;
+                const auto & a = item.second;
+                const auto & b = it->second;
+                BOOST_CHECK(a.getVote() == b.getVote());
+                BOOST_CHECK(a.getUtxo() == b.getUtxo());
+                BOOST_CHECK(a.getOutpoint() == b.getOutpoint());
+                BOOST_CHECK_EQUAL(a.getBlockNumber(), b.getBlockNumber());
+                BOOST_CHECK_EQUAL(a.spent(), b.spent());
+            }
+            checkBaseline("4 thread");
         }
 
         // Load governance data with default multiple threads
@@ -3159,6 +3231,7 @@ BOOST_AUTO_TEST_CASE(governance_tests_loadgovernancedata_votes)
                                                                       "expected %u, spent or invalid %u", gvotes.size(), expecting, spent));
             BOOST_CHECK_MESSAGE(gvotes.size() == cvs.size(), strprintf("Failed to load governance data votes, found %u "
                                                                        "expected %u, spent or invalid %u", gvotes.size(), cvs.size(), spent));
+            checkBaseline("multi threaded");
         }
     }
 
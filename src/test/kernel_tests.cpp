@@ -0,0 +1,98 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <amount.h>
+#include <chainparams.h>
+#include <kernel.h>
+#include <streams.h>
+#include <test/test_bitcoin.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(kernel_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(kernel_hasher_matches_stream)
+{
+    for (int n = 0; n < 500; ++n) {
+        const uint64_t stakeModifier = InsecureRandBits(64);
+        const uint256 hashBlockFrom = InsecureRand256();
+        const uint256 prevoutHash = InsecureRand256();
+        const unsigned int nTimeBlockFrom = InsecureRand32();
+        const int blockHeight = static_cast<int>(InsecureRandRange(5000000));
+        const unsigned int prevoutIndex = static_cast<unsigned int>(InsecureRandRange(100));
+        const unsigned int nTimeTx = InsecureRand32();
+
+        CDataStream ss(SER_GETHASH, 0);
+        ss << stakeModifier;
+        BOOST_CHECK(StakeKernelHasher::V06(stakeModifier, hashBlockFrom, nTimeBlockFrom, blockHeight, prevoutIndex).Hash(nTimeTx)
+                    == stakeHashV06(ss, hashBlockFrom, nTimeBlockFrom, blockHeight, prevoutIndex, nTimeTx));
+        BOOST_CHECK(StakeKernelHasher::V05(stakeModifier, nTimeBlockFrom, blockHeight, prevoutIndex).Hash(nTimeTx)
+                    == stakeHashV05(ss, nTimeBlockFrom, blockHeight, prevoutIndex, nTimeTx));
+        BOOST_CHECK(StakeKernelHasher::V03(stakeModifier, nTimeBlockFrom, prevoutIndex, prevoutHash).Hash(nTimeTx)
+                    == stakeHash(nTimeTx, ss, prevoutIndex, prevoutHash, nTimeBlockFrom));
+    }
+
+    // Batched hashes must match single hashes
+    const auto hasher = StakeKernelHasher::V06(InsecureRandBits(64), InsecureRand256(), InsecureRand32(), 1000, 1);
+    std::vector<uint256> hashes(40);
+    hasher.Hash(1000, hashes.size(), hashes.data());
+    for (unsigned int i = 0; i < hashes.size(); ++i)
+        BOOST_CHECK(hashes[i] == hasher.Hash(1000 + i));
+}
+
+BOOST_AUTO_TEST_CASE(kernel_target_matches_arith)
+{
+    const auto & consensus = Params().GetConsensus();
+    for (int n = 0; n < 100; ++n) {
+        arith_uint256 bnTargetPerCoinDay;
+        bnTargetPerCoinDay.SetCompact(0x1e00ffff - static_cast<uint32_t>(InsecureRandRange(0x300000)));
+        const int64_t nValueIn = static_cast<int64_t>(InsecureRandRange(100000 * COIN));
+        const int64_t prevTime = consensus.stakingV07UpgradeTime + static_cast<int64_t>(InsecureRandRange(10000));
+        StakeKernelTarget targetV07(consensus.stakingV07UpgradeTime, prevTime, nValueIn, bnTargetPerCoinDay, consensus);
+        StakeKernelTarget targetLegacy(0, prevTime, nValueIn, bnTargetPerCoinDay, consensus);
+        for (int64_t t = prevTime; t < prevTime + 300; ++t) {
+            const uint256 hash = InsecureRand256();
+            BOOST_CHECK_EQUAL(targetV07.Hit(hash, t), stakeTargetHitV07(hash, t, prevTime, nValueIn, bnTargetPerCoinDay, consensus.nPowTargetSpacing));
+            BOOST_CHECK_EQUAL(targetLegacy.Hit(hash, t), stakeTargetHit(hash, nValueIn, bnTargetPerCoinDay));
+        }
+    }
+
+    for (int n = 0; n < 1000; ++n) {
+        const uint256 a = InsecureRand256();
+        uint256 b = InsecureRand256();
+        if (n % 2 == 0) // exercise equal high words
+            memcpy(b.begin() + 8, a.begin() + 8, 24);
+        BOOST_CHECK_EQUAL(stakeHashBelowTarget(a, b), UintToArith256(a) < UintToArith256(b));
+    }
+    const uint256 a = InsecureRand256();
+    BOOST_CHECK(!stakeHashBelowTarget(a, a));
+}
+
+BOOST_AUTO_TEST_CASE(proof_of_stake_cache_bounded)
+{
+    const auto first = InsecureRand256();
+    const auto firstPos = InsecureRand256();
+    SetHashProofOfStake(first, firstPos);
+    BOOST_CHECK(HasHashProofOfStake(first));
+    BOOST_CHECK(GetHashProofOfStake(first) == firstPos);
+
+    // Consumed entries are removed
+    uint256 hashProofOfStake;
+    BOOST_CHECK(TakeHashProofOfStake(first, hashProofOfStake));
+    BOOST_CHECK(hashProofOfStake == firstPos);
+    BOOST_CHECK(!HasHashProofOfStake(first));
+    BOOST_CHECK(!TakeHashProofOfStake(first, hashProofOfStake));
+
+    // Oldest entries are evicted once the cache is full
+    const auto oldest = InsecureRand256();
+    SetHashProofOfStake(oldest, InsecureRand256());
+    for (unsigned int i = 0; i < MAX_PROOF_OF_STAKE_CACHE * 2; ++i)
+        SetHashProofOfStake(InsecureRand256(), InsecureRand256());
+    BOOST_CHECK(!HasHashProofOfStake(oldest));
+    BOOST_CHECK(HashProofOfStakeCacheSize() <= MAX_PROOF_OF_STAKE_CACHE);
+    BOOST_CHECK(HashProofOfStakeCacheUsage() > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
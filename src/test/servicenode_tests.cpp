@@ -1728,4 +1728,54 @@ BOOST_AUTO_TEST_CASE(servicenode_tests_rpc)
     pos_ptr.reset();
 }
 
+BOOST_FIXTURE_TEST_CASE(servicenode_tests_list_pages, BasicTestingSetup)
+{
+    sn::ServiceNodeMgr smgr;
+    const std::string config = R"({"xbridgeversion":50,"xrouterversion":50,"xrouter":{"config":"[Main]\nwallets=\nplugins=CustomPlugin1\nhost=127.0.0.1", "plugins":{"CustomPlugin1":""}}})";
+    const int count{30};
+    for (int i = 0; i < count; ++i) {
+        CKey key; key.MakeNewKey(true);
+        sn::ServiceNode snode(key.GetPubKey(), sn::ServiceNode::SPV, key.GetPubKey().GetID(),
+                              {COutPoint(uint256S("0x1"), i)}, 1, uint256S("0x1"), std::vector<unsigned char>());
+        sn::ServiceNodePing ping(key.GetPubKey(), 1, uint256S("0x1"), 1000 + i/3, config, snode); // 3 pings per ping time
+        ping.sign(key);
+        BOOST_CHECK(smgr.processPing(ping, true));
+    }
+
+    // Full list in a single page
+    sn::ServiceNodeListCursor next;
+    bool more{true};
+    auto page = smgr.getPings(sn::ServiceNodeListCursor(), next, more);
+    BOOST_CHECK_EQUAL(page.size(), static_cast<size_t>(count));
+    BOOST_CHECK(!more);
+
+    // Small pages must return every ping once and in order
+    const auto pingSize = GetSerializeSize(page.front(), PROTOCOL_VERSION);
+    std::vector<sn::ServiceNodePing> all;
+    sn::ServiceNodeListCursor cursor;
+    do {
+        page = smgr.getPings(cursor, next, more, pingSize * 4);
+        BOOST_CHECK(!page.empty());
+        BOOST_CHECK(cursor < next);
+        all.insert(all.end(), page.begin(), page.end());
+        cursor = next;
+    } while (more && all.size() <= static_cast<size_t>(count));
+    BOOST_CHECK_EQUAL(all.size(), static_cast<size_t>(count));
+    std::set<CPubKey> unique;
+    for (int i = 0; i < static_cast<int>(all.size()); ++i) {
+        unique.insert(all[i].getSnodePubKey());
+        if (i > 0)
+            BOOST_CHECK(all[i-1].getPingTime() <= all[i].getPingTime());
+    }
+    BOOST_CHECK_EQUAL(unique.size(), static_cast<size_t>(count));
+
+    // Since cursor only returns newer pings
+    page = smgr.getPings(sn::ServiceNodeListCursor(1000 + count/3 - 3, CPubKey()), next, more); // invalid pubkey sorts last
+    BOOST_CHECK_EQUAL(page.size(), 6);
+    cursor = next;
+    page = smgr.getPings(cursor, next, more);
+    BOOST_CHECK(page.empty());
+    BOOST_CHECK(!more);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
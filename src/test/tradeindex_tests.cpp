@@ -0,0 +1,176 @@
+// Copyright (c) 2019 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <index/tradeindex.h>
+#include <script/standard.h>
+#include <test/test_bitcoin.h>
+#include <util/time.h>
+#include <validation.h>
+#include <validationinterface.h>
+#include <xbridge/util/xseries.h>
+
+#include <boost/test/unit_test.hpp>
+
+/**
+ * Returns a bare multisig script carrying an xbridge trade fee record, the
+ * same encoding used by xbridge fee transactions.
+ */
+static CScript TradeScript(const CPubKey & snode, const std::string & id, const std::string & from,
+                           const uint64_t fromAmount, const std::string & to, const uint64_t toAmount)
+{
+    std::string json = strprintf("[\"%s\",\"%s\",%u,\"%s\",%u]", id, from, fromAmount, to, toAmount);
+    json.resize((json.size() + 63) / 64 * 64, ' ');
+
+    CScript script = CScript() << OP_1 << ToByteVector(snode);
+    for (size_t i = 0; i < json.size(); i += 64) {
+        std::vector<unsigned char> chunk{0x04};
+        chunk.insert(chunk.end(), json.begin() + i, json.begin() + i + 64);
+        script << chunk;
+    }
+    script << CScript::EncodeOP_N(1 + json.size() / 64) << OP_CHECKMULTISIG;
+    return script;
+}
+
+/** Returns the order ids in the LTC/BLOCK series around the specified time. */
+static std::vector<std::string> SeriesOrderIds(xSeriesCache & cache, const int64_t time)
+{
+    xQuery query{"LTC", "BLOCK", 60, time - 3600, time + 600,
+                 xQuery::WithTxids::Included, xQuery::WithInverse::Excluded,
+                 xQuery::IntervalLimit{}, xQuery::IntervalTimestamp{}};
+    BOOST_REQUIRE(!query.error());
+    std::vector<std::string> ids;
+    for (const auto & x : cache.getXAggregateSeries(query))
+        ids.insert(ids.end(), x.orderIds.begin(), x.orderIds.end());
+    return ids;
+}
+
+BOOST_AUTO_TEST_SUITE(tradeindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(tradeindex_sync_and_disconnect, TestChain100Setup)
+{
+    CKey snodeKey;
+    snodeKey.MakeNewKey(true);
+    const std::vector<CMutableTransaction> no_txns;
+
+    // Trade recorded before the index is started
+    const CBlock block1 = CreateAndProcessBlock(no_txns, TradeScript(snodeKey.GetPubKey(), "a1", "LTC", 100, "BLOCK", 200));
+    const int height1 = chainActive.Height();
+
+    TradeIndex tradeindex(1 << 20, true);
+    RegisterValidationInterface(&tradeindex);
+    tradeindex.Start();
+
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!tradeindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        MilliSleep(100);
+    }
+
+    std::vector<TradeRecord> records;
+    BOOST_CHECK(tradeindex.FindTrades(0, height1, records));
+    BOOST_REQUIRE_EQUAL(records.size(), 1);
+    BOOST_CHECK_EQUAL(records[0].height, height1);
+    BOOST_CHECK_EQUAL(records[0].time, block1.GetBlockTime());
+    BOOST_CHECK(records[0].txid == block1.vtx[0]->GetHash());
+    BOOST_CHECK_EQUAL(records[0].xid, "a1");
+    BOOST_CHECK_EQUAL(records[0].fromCurrency, "LTC");
+    BOOST_CHECK_EQUAL(records[0].fromAmount, 100);
+    BOOST_CHECK_EQUAL(records[0].toCurrency, "BLOCK");
+    BOOST_CHECK_EQUAL(records[0].toAmount, 200);
+    BOOST_CHECK(!records[0].IsError());
+
+    // Trade in a block connected after the index is synced
+    CreateAndProcessBlock(no_txns, TradeScript(snodeKey.GetPubKey(), "b2", "BTC", 300, "LTC", 400));
+    const int height2 = chainActive.Height();
+    SyncWithValidationInterfaceQueue();
+
+    records.clear();
+    BOOST_CHECK(tradeindex.FindTrades(height1, height2, records));
+    BOOST_REQUIRE_EQUAL(records.size(), 2);
+    BOOST_CHECK_EQUAL(records[1].xid, "b2");
+    BOOST_CHECK_EQUAL(records[1].height, height2);
+
+    // Disconnecting the tip drops its trades
+    {
+        CValidationState state;
+        CBlockIndex* tip;
+        {
+            LOCK(cs_main);
+            tip = chainActive.Tip();
+        }
+        BOOST_CHECK(InvalidateBlock(state, Params(), tip));
+    }
+    SyncWithValidationInterfaceQueue();
+
+    records.clear();
+    BOOST_CHECK(tradeindex.FindTrades(0, height2, records));
+    BOOST_REQUIRE_EQUAL(records.size(), 1);
+    BOOST_CHECK_EQUAL(records[0].xid, "a1");
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    UnregisterValidationInterface(&tradeindex);
+    tradeindex.Stop();
+
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+
+    // Rest of shutdown sequence and destructors happen in ~TestingSetup()
+}
+
+BOOST_FIXTURE_TEST_CASE(tradeindex_series_cache, TestChain100Setup)
+{
+    CKey snodeKey;
+    snodeKey.MakeNewKey(true);
+    const std::vector<CMutableTransaction> no_txns;
+
+    g_tradeindex = MakeUnique<TradeIndex>(1 << 20, true);
+    RegisterValidationInterface(g_tradeindex.get());
+    g_tradeindex->Start();
+    int64_t time_start = GetTimeMillis();
+    while (!g_tradeindex->BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + 10 * 1000 > GetTimeMillis());
+        MilliSleep(100);
+    }
+    xSeriesCache cache;
+    RegisterValidationInterface(&cache);
+
+    const CBlock block1 = CreateAndProcessBlock(no_txns, TradeScript(snodeKey.GetPubKey(), "a1", "LTC", 100, "BLOCK", 200));
+    const int64_t time = block1.GetBlockTime();
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(SeriesOrderIds(cache, time) == std::vector<std::string>({"a1"}));
+
+    // Connected blocks are added to the cached series
+    CreateAndProcessBlock(no_txns, TradeScript(snodeKey.GetPubKey(), "b2", "LTC", 300, "BLOCK", 400));
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(SeriesOrderIds(cache, time) == std::vector<std::string>({"a1", "b2"}));
+
+    // Disconnected blocks are retracted from the cached series
+    {
+        CValidationState state;
+        CBlockIndex* tip;
+        {
+            LOCK(cs_main);
+            tip = chainActive.Tip();
+        }
+        BOOST_CHECK(InvalidateBlock(state, Params(), tip));
+    }
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(SeriesOrderIds(cache, time) == std::vector<std::string>({"a1"}));
+
+    UnregisterValidationInterface(&cache);
+    UnregisterValidationInterface(g_tradeindex.get());
+    g_tradeindex->Stop();
+    g_tradeindex.reset();
+
+    // Queries fail without the trade index
+    BOOST_CHECK_THROW(SeriesOrderIds(cache, time), std::runtime_error);
+
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,10 +2,91 @@
 // Copyright (c) 2020 The Blocknet developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
+#include <test/xbridge_tests.h>
 #include <test/test_bitcoin.h>
+#include <compat.h>
+#include <tinyformat.h>
+#include <util/time.h>
+#include <xbridge/util/rpcclientpool.h>
 #include <xbridge/util/xutil.h>
+#include <xbridge/xbridgeorderbook.h>
+#include <xbridge/xbridgetransactiondescr.h>
+
+#include <atomic>
+
+#include <event2/buffer.h>
+#include <event2/thread.h>
 #include <boost/test/unit_test.hpp>
 
+TestRPCServer::TestRPCServer(const size_t holdCount, ReplyFunc replyFunc)
+    : holdCount(holdCount), replyFunc(std::move(replyFunc))
+{
+#ifdef WIN32
+    evthread_use_windows_threads();
+#else
+    evthread_use_pthreads();
+#endif
+    base = obtain_event_base();
+    http = obtain_evhttp(base.get());
+    evhttp_set_gencb(http.get(), handleRequest, this);
+    auto bound = evhttp_bind_socket_with_handle(http.get(), "127.0.0.1", 0);
+    if (!bound)
+        throw std::runtime_error("test rpc server bind failed");
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    getsockname(evhttp_bound_socket_get_fd(bound), (struct sockaddr*)&addr, &len);
+    port = ntohs(addr.sin_port);
+    thread = std::thread([this]() { event_base_dispatch(base.get()); });
+}
+
+TestRPCServer::~TestRPCServer() {
+    event_base_once(base.get(), -1, EV_TIMEOUT, [](evutil_socket_t, short, void *ctx) {
+        event_base_loopbreak(static_cast<struct event_base*>(ctx));
+    }, base.get(), nullptr);
+    thread.join();
+}
+
+std::string TestRPCServer::endpoint() const {
+    return strprintf("127.0.0.1:%d", port);
+}
+
+void TestRPCServer::handleRequest(struct evhttp_request *req, void *ctx) {
+    auto server = static_cast<TestRPCServer*>(ctx);
+    if (server->dropCount > 0) {
+        --server->dropCount;
+        // Freeing the connection inside the request callback is unsafe, close it on the next loop
+        event_base_once(server->base.get(), -1, EV_TIMEOUT, [](evutil_socket_t, short, void *evcon) {
+            evhttp_connection_free(static_cast<struct evhttp_connection*>(evcon));
+        }, evhttp_request_get_connection(req), nullptr);
+        return;
+    }
+    server->held.push_back(req);
+    if (server->held.size() < server->holdCount)
+        return;
+    for (auto r : server->held) {
+        std::string reply{"{\"result\":null,\"error\":null,\"id\":1}"};
+        if (server->replyFunc) {
+            struct evbuffer *input = evhttp_request_get_input_buffer(r);
+            const size_t size = evbuffer_get_length(input);
+            const char *data = (const char*)evbuffer_pullup(input, size);
+            reply = server->replyFunc(data ? std::string(data, size) : std::string());
+        }
+        evbuffer_add(evhttp_request_get_output_buffer(r), reply.data(), reply.size());
+        evhttp_send_reply(r, HTTP_OK, "OK", nullptr);
+    }
+    server->held.clear();
+}
+
+namespace {
+
+std::string PostTestRPC(const TestRPCServer & server) {
+    return xbridge::RPCClientPool::instance().post("127.0.0.1", server.port, "user", "pass",
+                                                   "{\"method\":\"getblockcount\",\"params\":[],\"id\":1}",
+                                                   "application/json", 5);
+}
+
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(xbridge_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(xbridge_partialorderdriftcheck) {
@@ -130,4 +211,205 @@ BOOST_AUTO_TEST_CASE(xbridge_pricecheck) {
     }
 }
 
+
+BOOST_AUTO_TEST_CASE(xbridge_orderbook) {
+    auto order = [](const std::string & from, const uint64_t fromAmount, const std::string & to, const uint64_t toAmount) {
+        auto ptr = std::make_shared<xbridge::TransactionDescr>();
+        ptr->id = GetRandHash();
+        ptr->fromCurrency = from;
+        ptr->fromAmount = fromAmount;
+        ptr->toCurrency = to;
+        ptr->toAmount = toAmount;
+        ptr->state = xbridge::TransactionDescr::trPending;
+        return ptr;
+    };
+
+    xbridge::OrderBook book;
+    auto a1 = order("LTC", 100, "BLOCK", 300); // price 3
+    auto a2 = order("LTC", 200, "BLOCK", 400); // price 2
+    auto a3 = order("LTC", 200, "BLOCK", 400); // price 2
+    auto b1 = order("BLOCK", 500, "LTC", 100); // other market
+    for (const auto & o : {a1, a2, a3, b1})
+        book.add(o);
+    BOOST_CHECK_EQUAL(book.size(), 4);
+
+    { // levels are grouped by price, lowest price first, currencies are case insensitive
+        const auto levels = book.levels("ltc", "block", 0, 0);
+        BOOST_CHECK_EQUAL(levels.size(), 2);
+        BOOST_CHECK_EQUAL(levels[0].orders.size(), 2);
+        BOOST_CHECK_EQUAL(levels[1].orders.size(), 1);
+        BOOST_CHECK(levels[1].orders[0] == a1);
+        BOOST_CHECK_EQUAL(book.levels("BLOCK", "LTC", 0, 0).size(), 1);
+    }
+    { // level and order limits
+        BOOST_CHECK_EQUAL(book.levels("LTC", "BLOCK", 1, 0).size(), 1);
+        const auto levels = book.levels("LTC", "BLOCK", 0, 1);
+        BOOST_CHECK_EQUAL(levels.size(), 1);
+        BOOST_CHECK_EQUAL(levels[0].orders.size(), 1);
+    }
+    { // orders that aren't open are skipped until they're open again
+        a2->state = xbridge::TransactionDescr::trAccepting;
+        a3->state = xbridge::TransactionDescr::trAccepting;
+        auto levels = book.levels("LTC", "BLOCK", 1, 0);
+        BOOST_CHECK(levels.size() == 1 && levels[0].orders[0] == a1);
+        a2->state = xbridge::TransactionDescr::trPending;
+        levels = book.levels("LTC", "BLOCK", 1, 0);
+        BOOST_CHECK(levels.size() == 1 && levels[0].orders[0] == a2);
+    }
+    { // orders with new amounts move to their new price when added again
+        a2->toAmount = 1000; // price 5
+        book.add(a2);
+        const auto levels = book.levels("LTC", "BLOCK", 0, 0);
+        BOOST_CHECK_EQUAL(levels.size(), 2);
+        BOOST_CHECK(levels[0].orders[0] == a1);
+        BOOST_CHECK(levels[1].orders[0] == a2);
+        BOOST_CHECK_EQUAL(book.size(), 4);
+    }
+    { // orders moving to a better price are returned ahead of the limits
+        a2->toAmount = 100; // price 0.5
+        book.add(a2);
+        const auto levels = book.levels("LTC", "BLOCK", 1, 1);
+        BOOST_CHECK(levels.size() == 1 && levels[0].orders[0] == a2);
+        BOOST_CHECK_CLOSE(levels[0].price, 0.5, 0.0001);
+    }
+    { // removed orders are gone
+        book.remove(a1->id);
+        book.remove(b1->id);
+        BOOST_CHECK_EQUAL(book.size(), 2);
+        BOOST_CHECK(book.levels("BLOCK", "LTC", 0, 0).empty());
+        const auto levels = book.levels("LTC", "BLOCK", 0, 0);
+        BOOST_CHECK(levels.size() == 1 && levels[0].orders[0] == a2);
+        book.clear();
+        BOOST_CHECK(book.levels("LTC", "BLOCK", 0, 0).empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(xbridge_jsonrpc_batch) {
+    BOOST_CHECK_EQUAL(xbridge::JSONRPCRequestBody("getblock", "[\"abc\",1]", 1),
+                      "{\"method\":\"getblock\",\"params\":[\"abc\",1],\"id\":1}");
+    BOOST_CHECK_EQUAL(xbridge::JSONRPCRequestBody("getblockcount", "[]", 1, "2.0"),
+                      "{\"jsonrpc\":\"2.0\",\"method\":\"getblockcount\",\"params\":[],\"id\":1}");
+
+    const auto batch = xbridge::JSONRPCBatchBody({{"getblockhash", "[1]"}, {"getblockhash", "[2]"}});
+    UniValue requests;
+    BOOST_CHECK(requests.read(batch));
+    BOOST_CHECK_EQUAL(requests.size(), 2);
+    BOOST_CHECK_EQUAL(find_value(requests[1], "id").get_int(), 1);
+    BOOST_CHECK_EQUAL(find_value(requests[1], "params")[0].get_int(), 2);
+
+    // replies are matched to requests by id
+    const auto replies = xbridge::JSONRPCBatchReplies(
+            "[{\"result\":\"b\",\"error\":null,\"id\":1},{\"result\":\"a\",\"error\":null,\"id\":0}]", 2);
+    BOOST_CHECK_EQUAL(replies.size(), 2);
+    BOOST_CHECK_EQUAL(find_value(replies[0], "result").get_str(), "a");
+    BOOST_CHECK_EQUAL(find_value(replies[1], "result").get_str(), "b");
+    BOOST_CHECK_THROW(xbridge::JSONRPCBatchReplies("[{\"result\":\"a\",\"error\":null,\"id\":0}]", 2), std::runtime_error);
+    BOOST_CHECK_THROW(xbridge::JSONRPCBatchReplies("{\"result\":null,\"error\":{},\"id\":null}", 1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(xbridge_rpcclientpool_reuse) {
+    auto & pool = xbridge::RPCClientPool::instance();
+    pool.clear();
+    TestRPCServer server;
+    TestRPCServer other;
+    const auto before = pool.stats()[server.endpoint()];
+
+    // calls to the same host:port share one keep-alive connection
+    for (int i = 0; i < 3; ++i)
+        BOOST_CHECK_EQUAL(PostTestRPC(server), "{\"result\":null,\"error\":null,\"id\":1}");
+    auto stats = pool.stats()[server.endpoint()];
+    BOOST_CHECK_EQUAL(stats.requests - before.requests, 3U);
+    BOOST_CHECK_EQUAL(stats.connections - before.connections, 1U);
+    BOOST_CHECK_EQUAL(stats.errors - before.errors, 0U);
+
+    // a different port doesn't get the idle connection
+    const auto otherBefore = pool.stats()[other.endpoint()];
+    PostTestRPC(other);
+    BOOST_CHECK_EQUAL(pool.stats()[other.endpoint()].connections - otherBefore.connections, 1U);
+    BOOST_CHECK_EQUAL(pool.stats()[server.endpoint()].connections - before.connections, 1U);
+    pool.clear();
+}
+
+BOOST_AUTO_TEST_CASE(xbridge_rpcclientpool_idle_timeout) {
+    auto & pool = xbridge::RPCClientPool::instance();
+    pool.clear();
+    TestRPCServer server;
+    const auto before = pool.stats()[server.endpoint()];
+
+    PostTestRPC(server);
+    SetMockTime(GetTime() + xbridge::RPC_POOL_IDLE_TIMEOUT - 1);
+    PostTestRPC(server); // still idle within the timeout, reused
+    BOOST_CHECK_EQUAL(pool.stats()[server.endpoint()].connections - before.connections, 1U);
+    SetMockTime(GetTime() + xbridge::RPC_POOL_IDLE_TIMEOUT + 1);
+    PostTestRPC(server); // expired, reconnects
+    BOOST_CHECK_EQUAL(pool.stats()[server.endpoint()].connections - before.connections, 2U);
+    SetMockTime(0);
+    pool.clear();
+}
+
+BOOST_AUTO_TEST_CASE(xbridge_rpcclientpool_max_idle) {
+    auto & pool = xbridge::RPCClientPool::instance();
+    pool.clear();
+    // The server holds the replies until all requests arrived, each call needs its own connection
+    const size_t calls = xbridge::RPC_POOL_MAX_IDLE + 2;
+    TestRPCServer server(calls);
+    const auto before = pool.stats()[server.endpoint()];
+
+    std::atomic<int> failed{0};
+    auto postConcurrent = [&]() {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < calls; ++i) {
+            threads.emplace_back([&]() {
+                try {
+                    PostTestRPC(server);
+                } catch (...) {
+                    ++failed;
+                }
+            });
+        }
+        for (auto & t : threads)
+            t.join();
+    };
+
+    postConcurrent();
+    BOOST_CHECK_EQUAL(pool.stats()[server.endpoint()].connections - before.connections, calls);
+    // only RPC_POOL_MAX_IDLE connections were kept, the rest are opened again
+    postConcurrent();
+    BOOST_CHECK_EQUAL(pool.stats()[server.endpoint()].connections - before.connections,
+                      calls + (calls - xbridge::RPC_POOL_MAX_IDLE));
+    BOOST_CHECK_EQUAL(failed.load(), 0);
+    pool.clear();
+}
+
+BOOST_AUTO_TEST_CASE(xbridge_rpcclientpool_drop_failed) {
+    auto & pool = xbridge::RPCClientPool::instance();
+    pool.clear();
+    TestRPCServer server;
+    const auto before = pool.stats()[server.endpoint()];
+
+    // server closes the connection without a reply (EOF), the connection isn't pooled
+    server.dropCount = 1;
+    BOOST_CHECK_THROW(PostTestRPC(server), std::runtime_error);
+    PostTestRPC(server);
+    auto stats = pool.stats()[server.endpoint()];
+    BOOST_CHECK_EQUAL(stats.requests - before.requests, 2U);
+    BOOST_CHECK_EQUAL(stats.errors - before.errors, 1U);
+    BOOST_CHECK_EQUAL(stats.connections - before.connections, 2U);
+
+    // unreachable server
+    std::string endpoint;
+    int port{0};
+    {
+        TestRPCServer closed;
+        endpoint = closed.endpoint();
+        port = closed.port;
+    }
+    const auto closedBefore = pool.stats()[endpoint];
+    BOOST_CHECK_THROW(pool.post("127.0.0.1", port, "", "", "{}", "application/json", 5), std::runtime_error);
+    BOOST_CHECK_THROW(pool.post("127.0.0.1", port, "", "", "{}", "application/json", 5), std::runtime_error);
+    BOOST_CHECK_EQUAL(pool.stats()[endpoint].errors - closedBefore.errors, 2U);
+    BOOST_CHECK_EQUAL(pool.stats()[endpoint].connections - closedBefore.connections, 2U);
+    pool.clear();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
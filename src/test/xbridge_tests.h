@@ -0,0 +1,46 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BLOCKNET_TEST_XBRIDGE_TESTS_H
+#define BLOCKNET_TEST_XBRIDGE_TESTS_H
+
+#include <support/events.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Local JSON-RPC server for the wallet rpc tests. Each request body is answered with
+ * the reply returned by replyFunc, or with a null result if there is none. Requests are
+ * held until holdCount of them arrived, the next dropCount requests are answered by
+ * closing the connection.
+ */
+class TestRPCServer
+{
+public:
+    typedef std::function<std::string(const std::string & body)> ReplyFunc;
+
+    explicit TestRPCServer(size_t holdCount = 1, ReplyFunc replyFunc = nullptr);
+    ~TestRPCServer();
+
+    std::string endpoint() const;
+
+    int port{0};
+    std::atomic<int> dropCount{0};
+
+private:
+    static void handleRequest(struct evhttp_request *req, void *ctx);
+
+    const size_t holdCount;
+    const ReplyFunc replyFunc;
+    std::vector<struct evhttp_request*> held; // only used on the server thread
+    raii_event_base base;
+    raii_evhttp http; // declared after base so it's freed first
+    std::thread thread;
+};
+
+#endif //BLOCKNET_TEST_XBRIDGE_TESTS_H
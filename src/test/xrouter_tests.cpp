@@ -3,6 +3,18 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <test/xrouter_tests.h>
+#include <test/xbridge_tests.h>
+#include <util/time.h>
+#include <xrouter/xrouterconnectorbtc.h>
+#include <xrouter/xrouterdef.h>
+#include <xrouter/xroutercache.h>
+#include <xrouter/xroutererror.h>
+#include <xrouter/xrouterquerymgr.h>
+#include <xrouter/xrouterscheduler.h>
+
+#include <deque>
+#include <thread>
+
 #include <boost/test/unit_test.hpp>
 
 XRouterTestClient::XRouterTestClient() {
@@ -22,11 +34,296 @@ XRouterTestClientTestnet::XRouterTestClientTestnet() : XRouterTestClient() {
     client = MakeUnique<xrouter::XRouterClient>(2, argv, connOptions);
 }
 
+namespace {
+
+/**
+ * Test wallet that answers getblock with the requested hash. Batch replies are sent
+ * in reverse order. Batches are rejected with a single error reply if batchSupported
+ * is false, failedBatches batches are answered with an incomplete reply.
+ */
+struct TestBatchWallet {
+    std::string reply(const std::string & body) {
+        UniValue request;
+        request.read(body);
+        std::lock_guard<std::mutex> lock(mu);
+        if (!request.isArray()) {
+            ++singles;
+            return replyTo(request).write();
+        }
+        batches.push_back(request.size());
+        if (!batchSupported)
+            return "{\"result\":null,\"error\":{\"code\":-32700,\"message\":\"Parse error\"},\"id\":null}";
+        if (failedBatches > 0) {
+            --failedBatches;
+            return "[]";
+        }
+        UniValue replies(UniValue::VARR);
+        for (size_t i = request.size(); i-- > 0; )
+            replies.push_back(replyTo(request[i]));
+        return replies.write();
+    }
+
+    int singleCalls() {
+        std::lock_guard<std::mutex> lock(mu);
+        return singles;
+    }
+
+    std::vector<size_t> batchSizes() {
+        std::lock_guard<std::mutex> lock(mu);
+        return batches;
+    }
+
+    static UniValue replyTo(const UniValue & request) {
+        UniValue r(UniValue::VOBJ);
+        r.pushKV("result", find_value(request, "params")[0]);
+        r.pushKV("error", NullUniValue);
+        r.pushKV("id", find_value(request, "id"));
+        return r;
+    }
+
+    std::mutex mu;
+    bool batchSupported{true};
+    int failedBatches{0};
+    int singles{0};
+    std::vector<size_t> batches;
+};
+
+std::vector<std::string> TestBlockHashes(const int count) {
+    std::vector<std::string> hashes;
+    for (int i = 0; i < count; ++i)
+        hashes.push_back(strprintf("%064x", i));
+    return hashes;
+}
+
+bool CheckBlockReplies(const std::vector<std::string> & hashes, const std::vector<std::string> & replies) {
+    if (hashes.size() != replies.size())
+        return false;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        UniValue reply;
+        if (!reply.read(replies[i]) || find_value(reply, "result").get_str() != hashes[i])
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
 BOOST_AUTO_TEST_SUITE(xrouter_tests)
 
 BOOST_AUTO_TEST_CASE(xrouter_tests_default) {
 }
 
+BOOST_AUTO_TEST_CASE(xrouter_tests_connector_scheduler) {
+    std::deque<xrouter::ConnectorScheduler::Work> posted;
+    bool postOk{true};
+    auto scheduler = std::make_shared<xrouter::ConnectorScheduler>("BTC", 1, 3, 2, 1,
+            [&posted, &postOk](const xrouter::NodeAddr & client, xrouter::ConnectorScheduler::Work work) {
+                if (postOk)
+                    posted.push_back(std::move(work));
+                return postOk;
+            });
+    std::vector<std::string> order;
+    std::vector<std::pair<std::string, xrouter::Error>> rejected;
+
+    auto reject = [&rejected](const std::string & client) {
+        return [&rejected, client](const xrouter::XRouterError & e) { rejected.emplace_back(client, e.code); };
+    };
+    // Returns the error if the request is refused right away
+    auto submit = [&](const std::string & client) {
+        const size_t count = rejected.size();
+        scheduler->submit(client, [&order, client]() { order.push_back(client); }, reject(client));
+        return rejected.size() > count ? rejected.back().second : xrouter::SUCCESS;
+    };
+    auto runPosted = [&posted]() {
+        while (!posted.empty()) {
+            auto work = std::move(posted.front());
+            posted.pop_front();
+            work();
+        }
+    };
+
+    // Requests queue up without blocking while the slot is busy
+    scheduler->submit("A", [&]() {
+        order.push_back("busy");
+        BOOST_CHECK_EQUAL(submit("A"), xrouter::SUCCESS);
+        BOOST_CHECK_EQUAL(submit("A"), xrouter::SUCCESS);
+        BOOST_CHECK_EQUAL(submit("A"), xrouter::TOO_MANY_REQUESTS); // client's share of the queue is full
+        BOOST_CHECK_EQUAL(submit("B"), xrouter::SUCCESS);
+        BOOST_CHECK_EQUAL(submit("C"), xrouter::TOO_MANY_REQUESTS); // queue is full
+        BOOST_CHECK_EQUAL(scheduler->stats().active, 1);
+        BOOST_CHECK_EQUAL(scheduler->stats().queued, 3);
+    }, reject("A"));
+
+    // Queued requests are posted one at a time, clients take turns
+    BOOST_CHECK_EQUAL(posted.size(), 1);
+    runPosted();
+    BOOST_CHECK(order == std::vector<std::string>({"busy", "A", "B", "A"}));
+    auto stats = scheduler->stats();
+    BOOST_CHECK_EQUAL(stats.served, 4);
+    BOOST_CHECK_EQUAL(stats.rejected, 2);
+    BOOST_CHECK_EQUAL(stats.active, 0);
+    BOOST_CHECK_EQUAL(stats.queued, 0);
+
+    // Requests give up after waiting maxWait seconds
+    rejected.clear();
+    scheduler->submit("A", [&]() {
+        submit("B");
+        MilliSleep(1100);
+    }, reject("A"));
+    BOOST_CHECK(posted.empty());
+    BOOST_CHECK(rejected == decltype(rejected)({{"B", xrouter::SERVER_TIMEOUT}}));
+    BOOST_CHECK_EQUAL(submit("B"), xrouter::SUCCESS);
+    BOOST_CHECK_EQUAL(scheduler->stats().queued, 0);
+
+    // Requests that can't be posted are refused and give up their slot
+    rejected.clear();
+    postOk = false;
+    scheduler->submit("A", [&]() { submit("B"); }, reject("A"));
+    BOOST_CHECK(rejected == decltype(rejected)({{"B", xrouter::TOO_MANY_REQUESTS}}));
+    BOOST_CHECK_EQUAL(scheduler->stats().active, 0);
+    postOk = true;
+
+    // Failed requests give up their slot
+    BOOST_CHECK_THROW(scheduler->submit("A", []() { throw std::runtime_error("wallet error"); }, reject("A")),
+                      std::runtime_error);
+    BOOST_CHECK_EQUAL(scheduler->stats().active, 0);
+
+    // Stopping rejects the queued requests and refuses new ones
+    rejected.clear();
+    scheduler->submit("A", [&]() {
+        submit("B");
+        scheduler->stop();
+    }, reject("A"));
+    BOOST_CHECK(posted.empty());
+    BOOST_CHECK_EQUAL(submit("C"), xrouter::INTERNAL_SERVER_ERROR);
+    BOOST_CHECK(rejected == decltype(rejected)({{"B", xrouter::INTERNAL_SERVER_ERROR}, {"C", xrouter::INTERNAL_SERVER_ERROR}}));
+    BOOST_CHECK_EQUAL(scheduler->stats().queued, 0);
+}
+
+BOOST_AUTO_TEST_CASE(xrouter_tests_response_cache) {
+    SetMockTime(1000);
+    const std::string reply(1000, 'x');
+    xrouter::ResponseCache cache(3500); // room for 3 replies
+    std::string r;
+
+    cache.put("a", reply, 10);
+    cache.put("b", reply, 100);
+    cache.put("c", reply, 100);
+    cache.put("d", reply, 0); // not cached
+    BOOST_CHECK(cache.get("a", r) && r == reply);
+    BOOST_CHECK(!cache.get("d", r));
+
+    // Least recently used reply makes room
+    cache.put("e", reply, 100);
+    BOOST_CHECK(!cache.get("b", r));
+    BOOST_CHECK(cache.get("a", r));
+    BOOST_CHECK(cache.get("c", r));
+    BOOST_CHECK(cache.get("e", r));
+
+    // Replies expire
+    SetMockTime(1010);
+    BOOST_CHECK(!cache.get("a", r));
+    BOOST_CHECK(cache.peek("c", r));
+
+    auto stats = cache.stats();
+    BOOST_CHECK_EQUAL(stats.entries, 2);
+    BOOST_CHECK_EQUAL(stats.hits, 4);
+    BOOST_CHECK_EQUAL(stats.misses, 3);
+    BOOST_CHECK_EQUAL(stats.evictions, 1);
+    BOOST_CHECK(stats.bytes <= stats.maxBytes);
+
+    cache.setMaxBytes(0);
+    BOOST_CHECK_EQUAL(cache.stats().entries, 0);
+    BOOST_CHECK_EQUAL(cache.stats().bytes, 0);
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_CASE(xrouter_tests_connector_batch) {
+    TestBatchWallet wallet;
+    TestRPCServer server(1, [&wallet](const std::string & body) { return wallet.reply(body); });
+    xrouter::BtcWalletConnectorXRouter conn;
+    conn.currency = "BTC";
+    conn.m_ip = "127.0.0.1";
+    conn.m_port = std::to_string(server.port);
+
+    // Calls are split into batches of XROUTER_RPC_BATCH_SIZE and replies are matched by id
+    const auto hashes = TestBlockHashes(XROUTER_RPC_BATCH_SIZE * 2 + 50);
+    BOOST_CHECK(CheckBlockReplies(hashes, conn.getBlocks(hashes)));
+    BOOST_CHECK(wallet.batchSizes() == std::vector<size_t>({XROUTER_RPC_BATCH_SIZE, XROUTER_RPC_BATCH_SIZE, 50}));
+    BOOST_CHECK_EQUAL(wallet.singleCalls(), 0);
+
+    // Duplicate hashes are only requested once
+    const std::vector<std::string> dups{hashes[1], hashes[0], hashes[1]};
+    BOOST_CHECK(CheckBlockReplies(dups, conn.getBlocks(dups)));
+    BOOST_CHECK_EQUAL(wallet.batchSizes().back(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(xrouter_tests_connector_batch_unsupported) {
+    TestBatchWallet wallet;
+    wallet.batchSupported = false;
+    TestRPCServer server(1, [&wallet](const std::string & body) { return wallet.reply(body); });
+    xrouter::BtcWalletConnectorXRouter conn;
+    conn.currency = "BTC";
+    conn.m_ip = "127.0.0.1";
+    conn.m_port = std::to_string(server.port);
+
+    // Wallet rejects the batch, the calls are made concurrently and batches aren't tried again
+    const auto hashes = TestBlockHashes(10);
+    BOOST_CHECK(CheckBlockReplies(hashes, conn.getBlocks(hashes)));
+    BOOST_CHECK_EQUAL(wallet.batchSizes().size(), 1U);
+    BOOST_CHECK_EQUAL(wallet.singleCalls(), 10);
+    BOOST_CHECK(CheckBlockReplies(hashes, conn.getBlocks(hashes)));
+    BOOST_CHECK_EQUAL(wallet.batchSizes().size(), 1U);
+    BOOST_CHECK_EQUAL(wallet.singleCalls(), 20);
+}
+
+BOOST_AUTO_TEST_CASE(xrouter_tests_connector_batch_failed) {
+    TestBatchWallet wallet;
+    wallet.failedBatches = 1;
+    TestRPCServer server(1, [&wallet](const std::string & body) { return wallet.reply(body); });
+    xrouter::BtcWalletConnectorXRouter conn;
+    conn.currency = "BTC";
+    conn.m_ip = "127.0.0.1";
+    conn.m_port = std::to_string(server.port);
+
+    // Incomplete batch reply, only this call falls back to concurrent requests
+    const auto hashes = TestBlockHashes(10);
+    BOOST_CHECK(CheckBlockReplies(hashes, conn.getBlocks(hashes)));
+    BOOST_CHECK_EQUAL(wallet.batchSizes().size(), 1U);
+    BOOST_CHECK_EQUAL(wallet.singleCalls(), 10);
+    BOOST_CHECK(CheckBlockReplies(hashes, conn.getBlocks(hashes)));
+    BOOST_CHECK_EQUAL(wallet.batchSizes().size(), 2U);
+    BOOST_CHECK_EQUAL(wallet.singleCalls(), 10);
+
+    // Connection lost during the batch
+    server.dropCount = 1;
+    BOOST_CHECK(CheckBlockReplies(hashes, conn.getBlocks(hashes)));
+    BOOST_CHECK_EQUAL(wallet.singleCalls(), 20);
+    BOOST_CHECK(CheckBlockReplies(hashes, conn.getBlocks(hashes)));
+    BOOST_CHECK_EQUAL(wallet.batchSizes().size(), 3U);
+    BOOST_CHECK_EQUAL(wallet.singleCalls(), 20);
+}
+
+BOOST_AUTO_TEST_CASE(xrouter_tests_querymgr_wait) {
+    xrouter::QueryMgr qm;
+    qm.addQuery("q1", "node1");
+    qm.addQuery("q1", "node2");
+
+    // Wakes up on the reply instead of waiting out the deadline
+    const auto start = std::chrono::steady_clock::now();
+    std::thread replier([&qm]() {
+        MilliSleep(50);
+        qm.addReply("q1", "node1", "{\"result\":1}");
+    });
+    BOOST_CHECK_EQUAL(qm.waitForReplies("q1", 1, start + std::chrono::seconds(30)), 1);
+    BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+    replier.join();
+
+    // Returns the replies received so far once the deadline passes
+    BOOST_CHECK_EQUAL(qm.waitForReplies("q1", 2, std::chrono::steady_clock::now() + std::chrono::milliseconds(50)), 1);
+    BOOST_CHECK_EQUAL(qm.waitForReplies("unknown", 1, std::chrono::steady_clock::now()), 0);
+}
+
 #ifdef USE_XROUTERCLIENT
 
 BOOST_FIXTURE_TEST_CASE(xrouter_tests_waitforservice, XRouterTestClientTestnet) {
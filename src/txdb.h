@@ -37,6 +37,8 @@ static const int64_t nMaxBlockDBCache = 16;
 // Unlike for the UTXO database, for the txindex scenario the leveldb cache make
 // a meaningful difference: https://github.com/bitcoin/bitcoin/pull/8273#issuecomment-229601991
 static const int64_t nMaxTxIndexCache = 3096;
+//! Max memory allocated to trade index DB specific cache (MiB)
+static const int64_t nMaxTradeIndexCache = 16;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 32;
 //! Max memory allocated to governance cache (MiB)
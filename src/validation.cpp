@@ -2953,14 +2953,13 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
         pindexNew->SetStakeEntropyBit(ebit);
         if (IsProofOfStake(pindexNew->nHeight)) {
             pindexNew->SetProofOfStake();
-            if (HasHashProofOfStake(hash))
-                pindexNew->hashProofOfStake = GetHashProofOfStake(hash);
+            uint256 hashProofOfStake;
+            if (TakeHashProofOfStake(hash, hashProofOfStake))
+                pindexNew->hashProofOfStake = hashProofOfStake;
             else {
-                uint256 hashProofOfStake;
                 if (!CheckProofOfStake(block, pindexNew->pprev, hashProofOfStake, Params().GetConsensus()))
                     LogPrint(BCLog::ALL, "AddToBlockIndex() : CheckProofOfStake failed\n");
                 pindexNew->hashProofOfStake = hashProofOfStake;
-                SetHashProofOfStake(block.GetHash(), hashProofOfStake);
             }
         }
 
@@ -3139,8 +3138,17 @@ static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state,
     uint256 blockHash = block.GetHash();
     uint256 hashProofOfStake;
     bool valid = CheckPoS(block, state, hashProofOfStake, consensusParams);
-    if (valid && !HasHashProofOfStake(blockHash))
-        SetHashProofOfStake(blockHash, hashProofOfStake);
+    if (valid && !HasHashProofOfStake(blockHash)) {
+        // Only blocks not yet in the block index take their hash from the cache,
+        // blocks checked again (e.g. ConnectBlock, VerifyDB) don't need an entry
+        bool indexed;
+        {
+            LOCK(cs_main);
+            indexed = LookupBlockIndex(blockHash) != nullptr;
+        }
+        if (!indexed)
+            SetHashProofOfStake(blockHash, hashProofOfStake);
+    }
     return valid;
 }
 
@@ -5177,12 +5185,22 @@ int GetChainTipHeight() {
     return chainActive.Height();
 }
 
+/**
+ * Proof-of-stake hashes computed during header checks, held until the block is added
+ * to the block index where the hash is stored on CBlockIndex (and persisted through
+ * CDiskBlockIndex). Entries are removed when consumed and the oldest entries are
+ * evicted once MAX_PROOF_OF_STAKE_CACHE is reached, which keeps the cache bounded
+ * regardless of chain length.
+ */
 Mutex muMapProofOfStake;
-std::map<uint256, uint256> mapProofOfStake;
+std::unordered_map<uint256, uint256, BlockHasher> mapProofOfStake GUARDED_BY(muMapProofOfStake);
+std::vector<uint256> vProofOfStakeEviction GUARDED_BY(muMapProofOfStake); // ring buffer, insertion order
+size_t nProofOfStakeEvictionPos GUARDED_BY(muMapProofOfStake) = 0;
 uint256 GetHashProofOfStake(const uint256 & blockHash) {
     LOCK(muMapProofOfStake);
-    if (mapProofOfStake.count(blockHash))
-        return mapProofOfStake[blockHash];
+    auto it = mapProofOfStake.find(blockHash);
+    if (it != mapProofOfStake.end())
+        return it->second;
     return {};
 }
 bool HasHashProofOfStake(const uint256 & blockHash) {
@@ -5191,5 +5209,35 @@ bool HasHashProofOfStake(const uint256 & blockHash) {
 }
 void SetHashProofOfStake(const uint256 & blockHash, const uint256 & hashProofOfStake) {
     LOCK(muMapProofOfStake);
+    auto it = mapProofOfStake.find(blockHash);
+    if (it != mapProofOfStake.end()) {
+        it->second = hashProofOfStake;
+        return;
+    }
+    if (vProofOfStakeEviction.empty())
+        vProofOfStakeEviction.resize(MAX_PROOF_OF_STAKE_CACHE);
+    // Evict the oldest entry, a no-op if it was already consumed
+    auto & slot = vProofOfStakeEviction[nProofOfStakeEvictionPos];
+    if (!slot.IsNull())
+        mapProofOfStake.erase(slot);
+    slot = blockHash;
+    nProofOfStakeEvictionPos = (nProofOfStakeEvictionPos + 1) % vProofOfStakeEviction.size();
     mapProofOfStake[blockHash] = hashProofOfStake;
+}
+bool TakeHashProofOfStake(const uint256 & blockHash, uint256 & hashProofOfStake) {
+    LOCK(muMapProofOfStake);
+    auto it = mapProofOfStake.find(blockHash);
+    if (it == mapProofOfStake.end())
+        return false;
+    hashProofOfStake = it->second;
+    mapProofOfStake.erase(it);
+    return true;
+}
+size_t HashProofOfStakeCacheSize() {
+    LOCK(muMapProofOfStake);
+    return mapProofOfStake.size();
+}
+size_t HashProofOfStakeCacheUsage() {
+    LOCK(muMapProofOfStake);
+    return memusage::DynamicUsage(mapProofOfStake) + memusage::DynamicUsage(vProofOfStakeEviction);
 }
\ No newline at end of file
@@ -553,9 +553,16 @@ bool IsServiceNodeBlockValidFunc(const uint64_t & blockNumber, const uint256 & b
  */
 extern int GetChainTipHeight();
 
+/** Maximum number of proof-of-stake hashes held for blocks not yet in the block index */
+static const unsigned int MAX_PROOF_OF_STAKE_CACHE = 5000;
+
 /** hashProofOfStake management */
 uint256 GetHashProofOfStake(const uint256 & blockHash);
 bool HasHashProofOfStake(const uint256 & blockHash);
 void SetHashProofOfStake(const uint256 & blockHash, const uint256 & hashProofOfStake);
+/** Removes the cached hash for the block once it's stored on the block index. Returns false if not cached. */
+bool TakeHashProofOfStake(const uint256 & blockHash, uint256 & hashProofOfStake);
+size_t HashProofOfStakeCacheSize();
+size_t HashProofOfStakeCacheUsage();
 
 #endif // BITCOIN_VALIDATION_H
@@ -245,6 +245,53 @@ BOOST_FIXTURE_TEST_CASE(staking_tests_nocoinstake, TestChainPoS)
     BOOST_CHECK_EQUAL(nDoS, 100);
 }
 
+/// Check that the stake search threads are reused and that their failures reach the staker thread
+BOOST_AUTO_TEST_CASE(staking_tests_searchpool)
+{
+    StakeSearchPool pool(4);
+    BOOST_CHECK_EQUAL(pool.Size(), 4);
+
+    // Every thread runs each job exactly once, same threads for every run
+    std::set<std::thread::id> threadIds;
+    for (int run = 0; run < 10; ++run) {
+        Mutex mu;
+        std::vector<int> ids;
+        pool.Run([&](const int id) {
+            LOCK(mu);
+            ids.push_back(id);
+            threadIds.insert(std::this_thread::get_id());
+        });
+        std::sort(ids.begin(), ids.end());
+        BOOST_CHECK(ids == std::vector<int>({0, 1, 2, 3}));
+    }
+    BOOST_CHECK_EQUAL(threadIds.size(), 4u);
+
+    // Exceptions thrown on a worker thread are rethrown on the caller
+    BOOST_CHECK_THROW(pool.Run([](const int id) {
+        if (id == 2)
+            throw std::runtime_error("search failed");
+    }), std::runtime_error);
+    // Including exceptions that aren't std::exception
+    BOOST_CHECK_THROW(pool.Run([](const int id) {
+        if (id == 3)
+            throw 1;
+    }), int);
+    // Caller thread failures are rethrown after the workers are done
+    std::atomic<int> finished{0};
+    BOOST_CHECK_THROW(pool.Run([&finished](const int id) {
+        if (id == 0)
+            throw std::runtime_error("search failed");
+        MilliSleep(10);
+        ++finished;
+    }), std::runtime_error);
+    BOOST_CHECK_EQUAL(finished.load(), 3);
+
+    // Pool is still usable after a failed run
+    std::atomic<int> ran{0};
+    pool.Run([&ran](const int) { ++ran; });
+    BOOST_CHECK_EQUAL(ran.load(), 4);
+}
+
 /// Check that v03 staking modifier doesn't change for each new selection interval
 BOOST_AUTO_TEST_CASE(staking_tests_v03modifier)
 {
@@ -1130,4 +1177,101 @@ BOOST_FIXTURE_TEST_CASE(staking_tests_walletorphans, TestChainPoS)
     wallet2.reset();
 }
 
+/// Check that the tracked stake outputs follow the wallet through mempool spends, blocks and reorgs
+BOOST_FIXTURE_TEST_CASE(staking_tests_stakeoutputcache, TestChainPoS)
+{
+    StakeOutputCache cache;
+    RegisterValidationInterface(&cache);
+
+    // Confirmed spendable outputs, unconfirmed outputs are never staked
+    auto outpoints = [](const std::vector<COutput> & coins) {
+        std::set<COutPoint> r;
+        for (const auto & coin : coins) {
+            if (coin.nDepth > 0 && coin.fSpendable)
+                r.insert(coin.GetInputCoin().outpoint);
+        }
+        return r;
+    };
+    auto tip = []() -> const CBlockIndex * {
+        LOCK(cs_main);
+        return chainActive.Tip();
+    };
+    auto tracked = [&](std::set<COutPoint> & result) -> bool {
+        std::vector<COutput> coins;
+        if (!cache.Outputs(wallet.get(), tip(), 1, coins))
+            return false;
+        result = outpoints(coins);
+        return true;
+    };
+    auto reset = [&]() {
+        const CBlockIndex *scanTip = nullptr;
+        const auto coins = staker.StakeOutputs(wallet.get(), 1, &scanTip);
+        cache.Reset(wallet.get(), coins, scanTip);
+    };
+    auto scanned = [&]() { return outpoints(staker.StakeOutputs(wallet.get(), 1)); };
+
+    std::set<COutPoint> outs;
+
+    // Wallets are seeded with a full scan
+    BOOST_CHECK(!tracked(outs));
+    reset();
+    BOOST_CHECK(tracked(outs));
+    BOOST_CHECK(!outs.empty());
+    BOOST_CHECK(outs == scanned());
+
+    // Outputs spent by mempool transactions are dropped
+    CTransactionRef tx;
+    BOOST_REQUIRE(sendToAddress(wallet.get(), GetDestinationForKey(coinbaseKey.GetPubKey(), OutputType::LEGACY), 10 * COIN, tx));
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(tracked(outs));
+    for (const auto & txin : tx->vin)
+        BOOST_CHECK(!outs.count(txin.prevout));
+    BOOST_CHECK(outs == scanned());
+
+    // Connected blocks add the new outputs without a rescan. The mock time is moved
+    // back afterwards to stay within the resync interval.
+    const auto resetTime = GetTime();
+    StakeBlocks(1); SyncWithValidationInterfaceQueue();
+    SetMockTime(resetTime);
+    BOOST_CHECK(tracked(outs));
+    BOOST_CHECK(outs == scanned());
+
+    // Disconnected blocks flag the wallet for a rescan, even once the block is reconnected
+    auto *disconnected = const_cast<CBlockIndex*>(tip());
+    {
+        CValidationState state;
+        BOOST_CHECK(InvalidateBlock(state, Params(), disconnected, false));
+        SyncWithValidationInterfaceQueue();
+        BOOST_CHECK(!tracked(outs));
+        {
+            LOCK(cs_main);
+            ResetBlockFailureFlags(disconnected);
+        }
+        BOOST_CHECK(ActivateBestChain(state, Params()));
+        SyncWithValidationInterfaceQueue();
+        BOOST_CHECK_EQUAL(tip()->GetBlockHash(), disconnected->GetBlockHash());
+        BOOST_CHECK(!tracked(outs));
+    }
+    reset();
+    BOOST_CHECK(tracked(outs));
+    BOOST_CHECK(outs == scanned());
+
+    // Removed wallet transactions are never dereferenced, the wallet is rescanned instead
+    {
+        std::vector<CWalletTx> zapped;
+        BOOST_CHECK(wallet->ZapWalletTx(zapped) == DBErrors::LOAD_OK);
+        BOOST_CHECK(!tracked(outs));
+        rescanWallet(wallet.get());
+    }
+    reset();
+    BOOST_CHECK(tracked(outs));
+    BOOST_CHECK(outs == scanned());
+
+    // Unloaded wallets are dropped
+    cache.Prune({});
+    BOOST_CHECK(!tracked(outs));
+
+    SyncWithValidationInterfaceQueue(); // no callbacks in flight when the cache is destroyed
+}
+
 BOOST_AUTO_TEST_SUITE_END()
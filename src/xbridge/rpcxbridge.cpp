@@ -15,6 +15,7 @@
 #include <xbridge/xbridgetransactiondescr.h>
 #include <xbridge/xuiconnector.h>
 
+#include <index/tradeindex.h>
 #include <init.h>
 #include <rpc/util.h>
 #include <shutdown.h>
@@ -1290,6 +1291,7 @@ UniValue dxTakeOrder(const JSONRPCRequest& request) {
         txDescr->fromAmount = txDescr->origFromAmount;
         txDescr->toCurrency = txDescr->origToCurrency;
         txDescr->toAmount = txDescr->origToAmount;
+        xbridge::App::instance().updateOrderBook(txDescr);
         return uret(xbridge::makeError(statusCode, __FUNCTION__));
     }
 }
@@ -1531,7 +1533,6 @@ UniValue dxGetOrderBook(const JSONRPCRequest& request)
     }
 
     Object res;
-    TransactionMap trList = xbridge::App::instance().transactions();
     {
         /**
          * @brief detaiLevel - Get a list of open orders for a product.
@@ -1567,186 +1568,33 @@ UniValue dxGetOrderBook(const JSONRPCRequest& request)
          */
         Array asks;
 
-        if(trList.empty())
-        {
-            LOG() << "empty transactions list";
-            res.emplace_back(Pair("asks", asks));
-            res.emplace_back(Pair("bids", bids));
-            return uret(res);
-        }
-
-        TransactionMap asksList;
-        TransactionMap bidsList;
-
-        //copy all transactions in currencies specified in the parameters
-
-        // ask orders are based in the first token in the trading pair
-        std::copy_if(trList.begin(), trList.end(), std::inserter(asksList, asksList.end()),
-                     [&toCurrency, &fromCurrency](const TransactionPair &transaction)
-        {
-            if(transaction.second == nullptr)
-                return false;
-            if (transaction.second->fromAmount <= 0 || transaction.second->toAmount <= 0)
-                return false;
-            if (transaction.second->state != xbridge::TransactionDescr::trPending)
-                return false;
-
-            return  ( boost::iequals(transaction.second->toCurrency, toCurrency) &&
-                      boost::iequals(transaction.second->fromCurrency, fromCurrency) );
-        });
-
-        // bid orders are based in the second token in the trading pair (inverse of asks)
-        std::copy_if(trList.begin(), trList.end(), std::inserter(bidsList, bidsList.end()),
-                     [&toCurrency, &fromCurrency](const TransactionPair &transaction)
-        {
-            if(transaction.second == nullptr)
-                return false;
-            if (transaction.second->fromAmount <= 0 || transaction.second->toAmount <= 0)
-                return false;
-            if (transaction.second->state != xbridge::TransactionDescr::trPending)
-                return false;
-
-            return  ( boost::iequals(transaction.second->toCurrency, fromCurrency) &&
-                      boost::iequals(transaction.second->fromCurrency, toCurrency));
-        });
-
-        std::vector<xbridge::TransactionDescrPtr> asksVector;
-        std::vector<xbridge::TransactionDescrPtr> bidsVector;
-
-        for (const auto &trEntry : asksList)
-            asksVector.emplace_back(trEntry.second);
-
-        for (const auto &trEntry : bidsList)
-            bidsVector.emplace_back(trEntry.second);
-
-        // sort asks descending
-        std::sort(asksVector.begin(), asksVector.end(),
-                  [](const xbridge::TransactionDescrPtr &a, const xbridge::TransactionDescrPtr &b)
-        {
-            const auto priceA = xbridge::price(a);
-            const auto priceB = xbridge::price(b);
-            return priceA > priceB;
-        });
-
-        //sort bids descending
-        std::sort(bidsVector.begin(), bidsVector.end(),
-                  [](const xbridge::TransactionDescrPtr &a, const xbridge::TransactionDescrPtr &b)
-        {
-            const auto priceA = xbridge::priceBid(a);
-            const auto priceB = xbridge::priceBid(b);
-            return priceA > priceB;
-        });
-
-        // floating point comparisons
-        // see Knuth 4.2.2 Eq 36
-        auto floatCompare = [](const double a, const double b) -> bool
-        {
-            const auto epsilon = std::numeric_limits<double>::epsilon();
-            return (fabs(a - b) / fabs(a) <= epsilon) && (fabs(a - b) / fabs(b) <= epsilon);
-        };
+        auto & xapp = xbridge::App::instance();
 
+        // ask orders are based in the first token in the trading pair, bid orders
+        // are based in the second token (inverse of asks). Both are returned
+        // best price first.
         switch (detailLevel)
         {
         case 1:
         {
             //return only the best bid and ask
-            if (!bidsList.empty()) {
-                const auto bidsItem = std::max_element(bidsList.begin(), bidsList.end(),
-                                       [](const TransactionPair &a, const TransactionPair &b)
-                {
-                    //find transaction with best bids
-                    const auto &tr1 = a.second;
-                    const auto &tr2 = b.second;
-
-                    if(tr1 == nullptr)
-                        return true;
-
-                    if(tr2 == nullptr)
-                        return false;
-
-                    const auto priceA = xbridge::priceBid(tr1);
-                    const auto priceB = xbridge::priceBid(tr2);
-
-                    return priceA < priceB;
-                });
-
-                const auto bidsCount = std::count_if(bidsList.begin(), bidsList.end(),
-                                                     [bidsItem, floatCompare](const TransactionPair &a)
-                {
-                    const auto &tr = a.second;
-
-                    if(tr == nullptr)
-                        return false;
-
-                    const auto price = xbridge::priceBid(tr);
-
-                    const auto &bestTr = bidsItem->second;
-                    if (bestTr != nullptr)
-                    {
-                        const auto bestBidPrice = xbridge::priceBid(bestTr);
-                        return floatCompare(price, bestBidPrice);
-                    }
-
-                    return false;
-                });
-
-                const auto &tr = bidsItem->second;
-                if (tr != nullptr)
-                {
-                    const auto bidPrice = xbridge::priceBid(tr);
-                    bids.emplace_back(Array{xbridge::xBridgeStringValueFromPrice(bidPrice),
-                                            xbridge::xBridgeStringValueFromAmount(tr->toAmount),
-                                            static_cast<int64_t>(bidsCount)});
-                }
+            const auto asksLevels = xapp.orderBook(fromCurrency, toCurrency, 1, 0);
+            const auto bidsLevels = xapp.orderBook(toCurrency, fromCurrency, 1, 0);
+
+            if (!bidsLevels.empty()) {
+                const auto & level = bidsLevels.front();
+                const auto & tr = level.orders.front();
+                bids.emplace_back(Array{xbridge::xBridgeStringValueFromPrice(xbridge::priceBid(tr)),
+                                        xbridge::xBridgeStringValueFromAmount(tr->toAmount),
+                                        static_cast<int64_t>(level.orders.size())});
             }
 
-            if (!asksList.empty()) {
-                const auto asksItem = std::min_element(asksList.begin(), asksList.end(),
-                                                   [](const TransactionPair &a, const TransactionPair &b)
-                {
-                    //find transactions with best asks
-                    const auto &tr1 = a.second;
-                    const auto &tr2 = b.second;
-
-                    if(tr1 == nullptr)
-                        return true;
-
-                    if(tr2 == nullptr)
-                        return false;
-
-                    const auto priceA = xbridge::price(tr1);
-                    const auto priceB = xbridge::price(tr2);
-                    return priceA < priceB;
-                });
-
-                const auto asksCount = std::count_if(asksList.begin(), asksList.end(),
-                                                     [asksItem, floatCompare](const TransactionPair &a)
-                {
-                    const auto &tr = a.second;
-
-                    if(tr == nullptr)
-                        return false;
-
-                    const auto price = xbridge::price(tr);
-
-                    const auto &bestTr = asksItem->second;
-                    if (bestTr != nullptr)
-                    {
-                        const auto bestAskPrice = xbridge::price(bestTr);
-                        return floatCompare(price, bestAskPrice);
-                    }
-
-                    return false;
-                });
-
-                const auto &tr = asksItem->second;
-                if (tr != nullptr)
-                {
-                    const auto askPrice = xbridge::price(tr);
-                    asks.emplace_back(Array{xbridge::xBridgeStringValueFromPrice(askPrice),
-                                            xbridge::xBridgeStringValueFromAmount(tr->fromAmount),
-                                            static_cast<int64_t>(asksCount)});
-                }
+            if (!asksLevels.empty()) {
+                const auto & level = asksLevels.front();
+                const auto & tr = level.orders.front();
+                asks.emplace_back(Array{xbridge::xBridgeStringValueFromPrice(xbridge::price(tr)),
+                                        xbridge::xBridgeStringValueFromAmount(tr->fromAmount),
+                                        static_cast<int64_t>(level.orders.size())});
             }
 
             res.emplace_back(Pair("asks", asks));
@@ -1756,75 +1604,32 @@ UniValue dxGetOrderBook(const JSONRPCRequest& request)
         case 2:
         {
             //Top X bids and asks (aggregated)
+            const auto asksLevels = xapp.orderBook(fromCurrency, toCurrency, maxOrders, 0);
+            const auto bidsLevels = xapp.orderBook(toCurrency, fromCurrency, maxOrders, 0);
 
-            /**
-             * @brief bound - calculate upper bound
-             */
-            auto bound = std::min<int32_t>(maxOrders, bidsVector.size());
-            for (size_t i = 0; i < bound; ++i) // Best bids are at the beginning of the stack (sorted descending, highest price better)
+            for (const auto & level : bidsLevels) // best bids first (highest price better)
             {
-                if(bidsVector[i] == nullptr)
-                    continue;
+                uint64_t bidSize{0};
+                for (const auto & tr : level.orders)
+                    bidSize += tr->toAmount;
 
                 Array bid;
-                //calculate bids and push to array
-                const auto bidAmount    = bidsVector[i]->toAmount;
-                const auto bidPrice     = xbridge::priceBid(bidsVector[i]);
-                auto bidSize            = bidAmount;
-                const auto bidsCount    = std::count_if(bidsList.begin(), bidsList.end(),
-                                                     [bidPrice, floatCompare](const TransactionPair &a)
-                {
-                    const auto &tr = a.second;
-
-                    if(tr == nullptr)
-                        return false;
-
-                    const auto price = xbridge::priceBid(tr);
-
-                    return floatCompare(price, bidPrice);
-                });
-                //array sorted by bid price, we can to skip the transactions with equals bid price
-                while((++i < bound) && floatCompare(xbridge::priceBid(bidsVector[i]), bidPrice)) {
-                    bidSize += bidsVector[i]->toAmount;
-                }
-                bid.emplace_back(xbridge::xBridgeStringValueFromPrice(bidPrice));
+                bid.emplace_back(xbridge::xBridgeStringValueFromPrice(xbridge::priceBid(level.orders.front())));
                 bid.emplace_back(xbridge::xBridgeStringValueFromAmount(bidSize));
-                bid.emplace_back(static_cast<int64_t>(bidsCount));
+                bid.emplace_back(static_cast<int64_t>(level.orders.size()));
                 bids.emplace_back(bid);
             }
 
-            bound = std::min<int32_t>(maxOrders, asksVector.size());
-            const auto asks_len = static_cast<int32_t>(asksVector.size());
-            for (int32_t i = asks_len - bound; i < asks_len; ++i) // Best asks are at the back of the stack (sorted descending, lowest price better)
+            for (auto it = asksLevels.rbegin(); it != asksLevels.rend(); ++it) // best asks last (lowest price better)
             {
-                if(asksVector[i] == nullptr)
-                    continue;
+                uint64_t askSize{0};
+                for (const auto & tr : it->orders)
+                    askSize += tr->fromAmount;
 
                 Array ask;
-                //calculate asks and push to array
-                const auto askAmount    = asksVector[i]->fromAmount;
-                const auto askPrice     = xbridge::price(asksVector[i]);
-                auto askSize            = askAmount;
-                const auto asksCount    = std::count_if(asksList.begin(), asksList.end(),
-                                                     [askPrice, floatCompare](const TransactionPair &a)
-                {
-                    const auto &tr = a.second;
-
-                    if(tr == nullptr)
-                        return false;
-
-                    const auto price = xbridge::price(tr);
-
-                    return floatCompare(price, askPrice);
-                });
-
-                //array sorted by price, we can to skip the transactions with equals price
-                while((++i < bound) && floatCompare(xbridge::price(asksVector[i]), askPrice)){
-                    askSize += asksVector[i]->fromAmount;
-                }
-                ask.emplace_back(xbridge::xBridgeStringValueFromPrice(askPrice));
+                ask.emplace_back(xbridge::xBridgeStringValueFromPrice(xbridge::price(it->orders.front())));
                 ask.emplace_back(xbridge::xBridgeStringValueFromAmount(askSize));
-                ask.emplace_back(static_cast<int64_t>(asksCount));
+                ask.emplace_back(static_cast<int64_t>(it->orders.size()));
                 asks.emplace_back(ask);
             }
 
@@ -1835,37 +1640,32 @@ UniValue dxGetOrderBook(const JSONRPCRequest& request)
         case 3:
         {
             //Full order book (non aggregated)
-            auto bound = std::min<int32_t>(maxOrders, bidsVector.size());
-            for (size_t i = 0; i < bound; ++i) // Best bids are at the beginning of the stack (sorted descending, highest price better)
-            {
-                if(bidsVector[i] == nullptr)
-                    continue;
-
-                Array bid;
-                const auto bidAmount   = bidsVector[i]->toAmount;
-                const auto bidPrice    = xbridge::priceBid(bidsVector[i]);
-                bid.emplace_back(xbridge::xBridgeStringValueFromPrice(bidPrice));
-                bid.emplace_back(xbridge::xBridgeStringValueFromAmount(bidAmount));
-                bid.emplace_back(bidsVector[i]->id.GetHex());
+            const auto asksLevels = xapp.orderBook(fromCurrency, toCurrency, 0, maxOrders);
+            const auto bidsLevels = xapp.orderBook(toCurrency, fromCurrency, 0, maxOrders);
 
-                bids.emplace_back(bid);
+            for (const auto & level : bidsLevels) // best bids first (highest price better)
+            {
+                for (const auto & tr : level.orders)
+                {
+                    Array bid;
+                    bid.emplace_back(xbridge::xBridgeStringValueFromPrice(xbridge::priceBid(tr)));
+                    bid.emplace_back(xbridge::xBridgeStringValueFromAmount(tr->toAmount));
+                    bid.emplace_back(tr->id.GetHex());
+                    bids.emplace_back(bid);
+                }
             }
 
-            bound = std::min<int32_t>(maxOrders, asksVector.size());
-            const auto asks_len = static_cast<int32_t>(asksVector.size());
-            for (int32_t i = asks_len - bound; i < asks_len; ++i) // Best asks are at the back of the stack (sorted descending, lowest price better)
+            for (auto it = asksLevels.rbegin(); it != asksLevels.rend(); ++it) // best asks last (lowest price better)
             {
-                if(asksVector[i] == nullptr)
-                    continue;
-
-                Array ask;
-                const auto bidAmount    = asksVector[i]->fromAmount;
-                const auto askPrice     = xbridge::price(asksVector[i]);
-                ask.emplace_back(xbridge::xBridgeStringValueFromPrice(askPrice));
-                ask.emplace_back(xbridge::xBridgeStringValueFromAmount(bidAmount));
-                ask.emplace_back(asksVector[i]->id.GetHex());
-
-                asks.emplace_back(ask);
+                for (auto oit = it->orders.rbegin(); oit != it->orders.rend(); ++oit)
+                {
+                    const auto & tr = *oit;
+                    Array ask;
+                    ask.emplace_back(xbridge::xBridgeStringValueFromPrice(xbridge::price(tr)));
+                    ask.emplace_back(xbridge::xBridgeStringValueFromAmount(tr->fromAmount));
+                    ask.emplace_back(tr->id.GetHex());
+                    asks.emplace_back(ask);
+                }
             }
 
             res.emplace_back(Pair("asks", asks));
@@ -1875,107 +1675,31 @@ UniValue dxGetOrderBook(const JSONRPCRequest& request)
         case 4:
         {
             //return Only the best bid and ask
-            if (!bidsList.empty()) {
-                const auto bidsItem = std::max_element(bidsList.begin(), bidsList.end(),
-                                           [](const TransactionPair &a, const TransactionPair &b)
-                {
-                    //find transaction with best bids
-                    const auto &tr1 = a.second;
-                    const auto &tr2 = b.second;
-
-                    if(tr1 == nullptr)
-                        return true;
-
-                    if(tr2 == nullptr)
-                        return false;
-
-                    const auto priceA = xbridge::priceBid(tr1);
-                    const auto priceB = xbridge::priceBid(tr2);
-
-                    return priceA < priceB;
-                });
-
-                const auto &tr = bidsItem->second;
-                if (tr != nullptr)
-                {
-                    const auto bidPrice = xbridge::priceBid(tr);
-                    bids.emplace_back(xbridge::xBridgeStringValueFromPrice(bidPrice));
-                    bids.emplace_back(xbridge::xBridgeStringValueFromAmount(tr->toAmount));
-
-                    Array bidsIds;
-                    bidsIds.emplace_back(tr->id.GetHex());
-
-                    for(const TransactionPair &tp : bidsList)
-                    {
-                        const auto &otherTr = tp.second;
-
-                        if(otherTr == nullptr)
-                            continue;
-
-                        if(tr->id == otherTr->id)
-                            continue;
-
-                        const auto otherTrBidPrice = xbridge::priceBid(otherTr);
-
-                        if(!floatCompare(bidPrice, otherTrBidPrice))
-                            continue;
-
-                        bidsIds.emplace_back(otherTr->id.GetHex());
-                    }
-
-                    bids.emplace_back(bidsIds);
-                }
+            const auto asksLevels = xapp.orderBook(fromCurrency, toCurrency, 1, 0);
+            const auto bidsLevels = xapp.orderBook(toCurrency, fromCurrency, 1, 0);
+
+            if (!bidsLevels.empty()) {
+                const auto & level = bidsLevels.front();
+                const auto & tr = level.orders.front();
+                bids.emplace_back(xbridge::xBridgeStringValueFromPrice(xbridge::priceBid(tr)));
+                bids.emplace_back(xbridge::xBridgeStringValueFromAmount(tr->toAmount));
+
+                Array bidsIds;
+                for (const auto & order : level.orders)
+                    bidsIds.emplace_back(order->id.GetHex());
+                bids.emplace_back(bidsIds);
             }
 
-            if (!asksList.empty()) {
-                const auto asksItem = std::min_element(asksList.begin(), asksList.end(),
-                                                   [](const TransactionPair &a, const TransactionPair &b)
-                {
-                    //find transactions with best asks
-                    const auto &tr1 = a.second;
-                    const auto &tr2 = b.second;
-
-                    if(tr1 == nullptr)
-                        return true;
-
-                    if(tr2 == nullptr)
-                        return false;
-
-                    const auto priceA = xbridge::price(tr1);
-                    const auto priceB = xbridge::price(tr2);
-                    return priceA < priceB;
-                });
-
-                const auto &tr = asksItem->second;
-                if (tr != nullptr)
-                {
-                    const auto askPrice = xbridge::price(tr);
-                    asks.emplace_back(xbridge::xBridgeStringValueFromPrice(askPrice));
-                    asks.emplace_back(xbridge::xBridgeStringValueFromAmount(tr->fromAmount));
-
-                    Array asksIds;
-                    asksIds.emplace_back(tr->id.GetHex());
-
-                    for(const TransactionPair &tp : asksList)
-                    {
-                        const auto &otherTr = tp.second;
-
-                        if(otherTr == nullptr)
-                            continue;
+            if (!asksLevels.empty()) {
+                const auto & level = asksLevels.front();
+                const auto & tr = level.orders.front();
+                asks.emplace_back(xbridge::xBridgeStringValueFromPrice(xbridge::price(tr)));
+                asks.emplace_back(xbridge::xBridgeStringValueFromAmount(tr->fromAmount));
 
-                        if(tr->id == otherTr->id)
-                            continue;
-
-                        const auto otherTrAskPrice = xbridge::price(otherTr);
-
-                        if(!floatCompare(askPrice, otherTrAskPrice))
-                            continue;
-
-                        asksIds.emplace_back(otherTr->id.GetHex());
-                    }
-
-                    asks.emplace_back(asksIds);
-                }
+                Array asksIds;
+                for (const auto & order : level.orders)
+                    asksIds.emplace_back(order->id.GetHex());
+                asks.emplace_back(asksIds);
             }
 
             res.emplace_back(Pair("asks", asks));
@@ -2679,14 +2403,55 @@ UniValue dxGetLockedUtxos(const JSONRPCRequest& request)
     return uret(obj);
 }
 
+/**
+ * @brief recentTrades - returns the trade records in the most recent blocks (no more
+ * than 30 days from the tip) from the trade index, newest block first
+ * @param countOfBlocks - maximum number of blocks
+ * @param records - (output) trade records
+ * @param errorMsg - (output) reason the trade records are not available
+ * @return false if the trade index is not available
+ */
+static bool recentTrades(uint32_t countOfBlocks, std::vector<TradeRecord> & records, std::string & errorMsg)
+{
+    if (!g_tradeindex) {
+        errorMsg = "The trade index is disabled, restart with -tradeindex=1";
+        return false;
+    }
+    if (!g_tradeindex->BlockUntilSyncedToCurrentChain()) {
+        errorMsg = "The trade index is syncing with the chain, try again shortly";
+        return false;
+    }
+
+    int startHeight{0}, endHeight{0};
+    {
+        LOCK(cs_main);
+        CBlockIndex * pindex = chainActive.Tip();
+        endHeight = pindex->nHeight;
+        int64_t timeBegin = pindex->GetBlockTime();
+        for (; pindex->pprev && pindex->GetBlockTime() > (timeBegin-30*24*60*60) && countOfBlocks > 0;
+                 pindex = pindex->pprev, --countOfBlocks);
+        startHeight = pindex->nHeight + 1;
+    }
+
+    if (!g_tradeindex->FindTrades(startHeight, endHeight, records)) {
+        errorMsg = "Failed to read the trade index";
+        return false;
+    }
+
+    // newest block first, trades in the same block stay in block order
+    std::stable_sort(records.begin(), records.end(), [](const TradeRecord & a, const TradeRecord & b) {
+        return a.height > b.height;
+    });
+    return true;
+}
+
 UniValue gettradingdata(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 2)
         throw std::runtime_error(
             RPCHelpMan{"gettradingdata",
                 "\nReturns an object of XBridge trading records. This information is "
-                "pulled from on-chain history so pulling a large amount of blocks will "
-                "result in longer response times.\n",
+                "read from the on-chain trade index (-tradeindex).\n",
                 {
                     {"blocks", RPCArg::Type::NUM, "43200", "The number of blocks to return trade records for (60s block time)."},
                     {"errors", RPCArg::Type::BOOL, "false", "show errors"},
@@ -2725,54 +2490,45 @@ UniValue gettradingdata(const JSONRPCRequest& request)
         countOfBlocks = params[0].get_int();
     }
 
-    LOCK(cs_main);
+    std::vector<TradeRecord> trades;
+    std::string errorMsg;
+    if (!recentTrades(countOfBlocks, trades, errorMsg))
+        return uret(xbridge::makeError(xbridge::UNKNOWN_ERROR, __FUNCTION__, errorMsg));
 
     Array records;
 
-    CBlockIndex * pindex = chainActive.Tip();
-    int64_t timeBegin = chainActive.Tip()->GetBlockTime();
-    for (; pindex->pprev && pindex->GetBlockTime() > (timeBegin-30*24*60*60) && countOfBlocks > 0;
-             pindex = pindex->pprev, --countOfBlocks)
+    for (const TradeRecord & trade : trades)
     {
-        CBlock block;
-        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-        {
-            // throw
-            continue;
-        }
-        const auto timestamp = block.GetBlockTime();
-        for (const CTransactionRef & tx : block.vtx)
-        {
-            const auto txid = tx->GetHash().GetHex();
-            std::string snode_pubkey{};
-
-            const CurrencyPair p = TxOutToCurrencyPair(tx->vout, snode_pubkey);
-            switch(p.tag) {
-            case CurrencyPair::Tag::Error:
-                // Show errors
-                if (showErrors)
-                    records.emplace_back(Object{
+        const auto timestamp = trade.time;
+        const auto txid = trade.txid.GetHex();
+        const std::string & snode_pubkey = trade.snodeAddress;
+
+        const CurrencyPair p = TradeRecordToCurrencyPair(trade);
+        switch(p.tag) {
+        case CurrencyPair::Tag::Error:
+            // Show errors
+            if (showErrors)
+                records.emplace_back(Object{
+                    Pair{"timestamp",  timestamp},
+                    Pair{"txid",       txid},
+                    Pair{"xid",        p.error()}
+                });
+            break;
+        case CurrencyPair::Tag::Valid:
+            records.emplace_back(Object{
                         Pair{"timestamp",  timestamp},
                         Pair{"txid",       txid},
-                        Pair{"xid",        p.error()}
-                    });
-                break;
-            case CurrencyPair::Tag::Valid:
-                records.emplace_back(Object{
-                            Pair{"timestamp",  timestamp},
-                            Pair{"txid",       txid},
-                            Pair{"to",         snode_pubkey},
-                            Pair{"xid",        p.xid()},
-                            Pair{"from",       p.from.currency().to_string()},
-                            Pair{"fromAmount", p.from.amount<double>()},
-                            Pair{"to",         p.to.currency().to_string()},
-                            Pair{"toAmount",   p.to.amount<double>()},
-                            });
-                break;
-            case CurrencyPair::Tag::Empty:
-            default:
-                break;
-            }
+                        Pair{"to",         snode_pubkey},
+                        Pair{"xid",        p.xid()},
+                        Pair{"from",       p.from.currency().to_string()},
+                        Pair{"fromAmount", p.from.amount<double>()},
+                        Pair{"to",         p.to.currency().to_string()},
+                        Pair{"toAmount",   p.to.amount<double>()},
+                        });
+            break;
+        case CurrencyPair::Tag::Empty:
+        default:
+            break;
         }
     }
 
@@ -2785,8 +2541,7 @@ UniValue dxGetTradingData(const JSONRPCRequest& request)
         throw std::runtime_error(
             RPCHelpMan{"dxGetTradingData",
                 "\nReturns an object of XBridge trading records. This information is "
-                "pulled from on-chain history so pulling a large amount of blocks will "
-                "result in longer response times.\n",
+                "read from the on-chain trade index (-tradeindex).\n",
                 {
                     {"blocks", RPCArg::Type::NUM, "43200", "The number of blocks to return trade records for (60s block time)."},
                     {"errors", RPCArg::Type::BOOL, "false", "Shows an error if an error is detected."},
@@ -2853,54 +2608,45 @@ UniValue dxGetTradingData(const JSONRPCRequest& request)
         countOfBlocks = params[0].get_int();
     }
 
-    LOCK(cs_main);
+    std::vector<TradeRecord> trades;
+    std::string errorMsg;
+    if (!recentTrades(countOfBlocks, trades, errorMsg))
+        return uret(xbridge::makeError(xbridge::UNKNOWN_ERROR, __FUNCTION__, errorMsg));
 
     Array records;
 
-    CBlockIndex * pindex = chainActive.Tip();
-    int64_t timeBegin = chainActive.Tip()->GetBlockTime();
-    for (; pindex->pprev && pindex->GetBlockTime() > (timeBegin-30*24*60*60) && countOfBlocks > 0;
-             pindex = pindex->pprev, --countOfBlocks)
+    for (const TradeRecord & trade : trades)
     {
-        CBlock block;
-        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-        {
-            // throw
-            continue;
-        }
-        const auto timestamp = block.GetBlockTime();
-        for (const CTransactionRef & tx : block.vtx)
-        {
-            const auto txid = tx->GetHash().GetHex();
-            std::string snode_pubkey{};
-
-            const CurrencyPair p = TxOutToCurrencyPair(tx->vout, snode_pubkey);
-            switch(p.tag) {
-            case CurrencyPair::Tag::Error:
-                // Show errors
-                if (showErrors)
-                    records.emplace_back(Object{
+        const auto timestamp = trade.time;
+        const auto txid = trade.txid.GetHex();
+        const std::string & snode_pubkey = trade.snodeAddress;
+
+        const CurrencyPair p = TradeRecordToCurrencyPair(trade);
+        switch(p.tag) {
+        case CurrencyPair::Tag::Error:
+            // Show errors
+            if (showErrors)
+                records.emplace_back(Object{
+                    Pair{"timestamp",  timestamp},
+                    Pair{"fee_txid",   txid},
+                    Pair{"id",         p.error()}
+                });
+            break;
+        case CurrencyPair::Tag::Valid:
+            records.emplace_back(Object{
                         Pair{"timestamp",  timestamp},
                         Pair{"fee_txid",   txid},
-                        Pair{"id",         p.error()}
-                    });
-                break;
-            case CurrencyPair::Tag::Valid:
-                records.emplace_back(Object{
-                            Pair{"timestamp",  timestamp},
-                            Pair{"fee_txid",   txid},
-                            Pair{"nodepubkey", snode_pubkey},
-                            Pair{"id",         p.xid()},
-                            Pair{"taker",      p.from.currency().to_string()},
-                            Pair{"taker_size", p.from.amount<double>()},
-                            Pair{"maker",      p.to.currency().to_string()},
-                            Pair{"maker_size", p.to.amount<double>()},
-                            });
-                break;
-            case CurrencyPair::Tag::Empty:
-            default:
-                break;
-            }
+                        Pair{"nodepubkey", snode_pubkey},
+                        Pair{"id",         p.xid()},
+                        Pair{"taker",      p.from.currency().to_string()},
+                        Pair{"taker_size", p.from.amount<double>()},
+                        Pair{"maker",      p.to.currency().to_string()},
+                        Pair{"maker_size", p.to.amount<double>()},
+                        });
+            break;
+        case CurrencyPair::Tag::Empty:
+        default:
+            break;
         }
     }
 
@@ -0,0 +1,318 @@
+// Copyright (c) 2019 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <xbridge/util/rpcclientpool.h>
+
+#include <rpc/protocol.h>
+#include <support/events.h>
+#include <tinyformat.h>
+#include <util/strencodings.h>
+#include <util/time.h>
+
+#include <algorithm>
+
+#include <event2/buffer.h>
+
+//*****************************************************************************
+//*****************************************************************************
+namespace xbridge
+{
+
+namespace
+{
+    /** Reply structure for request_done to fill in */
+    struct HTTPReply
+    {
+        HTTPReply(struct event_base *base): base(base), status(0), error(-1) {}
+
+        struct event_base *base;
+        int status;
+        int error;
+        std::string body;
+    };
+
+    const char *http_errorstring(int code)
+    {
+        switch(code) {
+    #if LIBEVENT_VERSION_NUMBER >= 0x02010300
+        case EVREQ_HTTP_TIMEOUT:
+            return "timeout reached";
+        case EVREQ_HTTP_EOF:
+            return "EOF reached";
+        case EVREQ_HTTP_INVALID_HEADER:
+            return "error while reading header, or invalid header";
+        case EVREQ_HTTP_BUFFER_ERROR:
+            return "error encountered while reading or writing";
+        case EVREQ_HTTP_REQUEST_CANCEL:
+            return "request was canceled";
+        case EVREQ_HTTP_DATA_TOO_LONG:
+            return "response body is larger than allowed";
+    #endif
+        default:
+            return "unknown";
+        }
+    }
+
+    void http_request_done(struct evhttp_request *req, void *ctx)
+    {
+        HTTPReply *reply = static_cast<HTTPReply*>(ctx);
+
+        // The connection stays open after the reply, so the event loop
+        // has to be stopped explicitly
+        event_base_loopexit(reply->base, nullptr);
+
+        if (req == nullptr) {
+            /* If req is nullptr, it means an error occurred while connecting: the
+             * error code will have been passed to http_error_cb.
+             */
+            reply->status = 0;
+            return;
+        }
+
+        reply->status = evhttp_request_get_response_code(req);
+
+        struct evbuffer *buf = evhttp_request_get_input_buffer(req);
+        if (buf)
+        {
+            size_t size = evbuffer_get_length(buf);
+            const char *data = (const char*)evbuffer_pullup(buf, size);
+            if (data)
+                reply->body = std::string(data, size);
+            evbuffer_drain(buf, size);
+        }
+    }
+
+#if LIBEVENT_VERSION_NUMBER >= 0x02010300
+    void http_error_cb(enum evhttp_request_error err, void *ctx)
+    {
+        HTTPReply *reply = static_cast<HTTPReply*>(ctx);
+        reply->error = err;
+    }
+#endif
+}
+
+//*****************************************************************************
+//*****************************************************************************
+class RPCClientPool::Connection
+{
+public:
+    Connection(const std::string & host, const int port)
+        : base(obtain_event_base())
+        , evcon(obtain_evhttp_connection_base(base.get(), host, port))
+    {}
+
+    // evcon is declared after base so it's freed first
+    raii_event_base base;
+    raii_evhttp_connection evcon;
+    int64_t lastUsed{0};
+};
+
+//*****************************************************************************
+//*****************************************************************************
+RPCClientPool & RPCClientPool::instance()
+{
+    static RPCClientPool pool;
+    return pool;
+}
+
+//*****************************************************************************
+//*****************************************************************************
+std::unique_ptr<RPCClientPool::Connection> RPCClientPool::acquire(const std::string & endpoint,
+                                                                  const std::string & host, const int port)
+{
+    {
+        LOCK(m_lock);
+        auto it = m_idle.find(endpoint);
+        if (it != m_idle.end()) {
+            auto & idle = it->second;
+            const int64_t expired = GetTime() - RPC_POOL_IDLE_TIMEOUT;
+            idle.erase(std::remove_if(idle.begin(), idle.end(), [expired](const std::unique_ptr<Connection> & c) {
+                return c->lastUsed < expired;
+            }), idle.end());
+            if (!idle.empty()) {
+                auto conn = std::move(idle.back());
+                idle.pop_back();
+                // Let libevent notice if the server closed the connection
+                // while it was idle, it reconnects on the next request
+                event_base_loop(conn->base.get(), EVLOOP_NONBLOCK);
+                return conn;
+            }
+        }
+        ++m_stats[endpoint].connections;
+    }
+
+    // Synchronously look up hostname
+    return std::unique_ptr<Connection>(new Connection(host, port));
+}
+
+//*****************************************************************************
+//*****************************************************************************
+void RPCClientPool::release(const std::string & endpoint, std::unique_ptr<Connection> conn)
+{
+    conn->lastUsed = GetTime();
+    LOCK(m_lock);
+    auto & idle = m_idle[endpoint];
+    if (idle.size() < RPC_POOL_MAX_IDLE)
+        idle.push_back(std::move(conn));
+}
+
+//*****************************************************************************
+//*****************************************************************************
+std::string RPCClientPool::post(const std::string & host, const int port,
+                                const std::string & user, const std::string & passwd,
+                                const std::string & body, const std::string & contenttype,
+                                const int timeout)
+{
+    const std::string endpoint = strprintf("%s:%d", host, port);
+    const int64_t start = GetTimeMicros();
+
+    auto conn = acquire(endpoint, host, port);
+    evhttp_connection_set_timeout(conn->evcon.get(), timeout);
+
+    HTTPReply response(conn->base.get());
+    raii_evhttp_request req = obtain_evhttp_request(http_request_done, (void*)&response);
+    if (req == nullptr)
+        throw std::runtime_error("create http request failed");
+#if LIBEVENT_VERSION_NUMBER >= 0x02010300
+    evhttp_request_set_error_cb(req.get(), http_error_cb);
+#endif
+
+    struct evkeyvalq* output_headers = evhttp_request_get_output_headers(req.get());
+    assert(output_headers);
+    evhttp_add_header(output_headers, "Host", host.c_str());
+    // Set content type
+    if (!contenttype.empty())
+        evhttp_add_header(output_headers, "Content-Type", contenttype.c_str());
+    // Set credentials
+    if (!user.empty() || !passwd.empty()) {
+        std::string strRPCUserColonPass = user + ":" + passwd;
+        evhttp_add_header(output_headers, "Authorization", (std::string("Basic ") + EncodeBase64(strRPCUserColonPass)).c_str());
+    }
+
+    // Attach request data
+    struct evbuffer* output_buffer = evhttp_request_get_output_buffer(req.get());
+    assert(output_buffer);
+    evbuffer_add(output_buffer, body.data(), body.size());
+    evbuffer_add(output_buffer, "\n", 1);
+
+    int r = evhttp_make_request(conn->evcon.get(), req.get(), EVHTTP_REQ_POST, "/");
+    req.release(); // ownership moved to evcon in above call
+    if (r == 0)
+        event_base_dispatch(conn->base.get());
+
+    const int64_t latency = GetTimeMicros() - start;
+    const bool failed = r != 0 || response.status == 0 || response.status == HTTP_UNAUTHORIZED
+            || (response.status >= 400 && response.status != HTTP_BAD_REQUEST
+                && response.status != HTTP_NOT_FOUND && response.status != HTTP_INTERNAL_SERVER_ERROR)
+            || response.body.empty();
+    {
+        LOCK(m_lock);
+        auto & s = m_stats[endpoint];
+        ++s.requests;
+        if (failed)
+            ++s.errors;
+        s.totalLatency += latency;
+        s.maxLatency = std::max(s.maxLatency, latency);
+    }
+
+    // Connections are only reused after a complete exchange
+    if (response.status != 0)
+        release(endpoint, std::move(conn));
+
+    if (r != 0) {
+        throw std::runtime_error("send http request failed");
+    } else if (response.status == 0) {
+        std::string responseErrorMessage;
+        if (response.error != -1) {
+            responseErrorMessage = strprintf(" (error code %d - \"%s\")", response.error, http_errorstring(response.error));
+        }
+        throw std::runtime_error(strprintf("Could not connect to the server %s:%d%s\n\nMake sure the blocknetd server is running and that you are connecting to the correct RPC port.", host, port, responseErrorMessage));
+    } else if (response.status == HTTP_UNAUTHORIZED) {
+        throw std::runtime_error("Authorization failed: Incorrect rpcuser or rpcpassword");
+    } else if (response.status >= 400 && response.status != HTTP_BAD_REQUEST && response.status != HTTP_NOT_FOUND && response.status != HTTP_INTERNAL_SERVER_ERROR)
+        throw std::runtime_error(strprintf("server returned HTTP error %d: %s", response.status, response.body));
+    else if (response.body.empty())
+        throw std::runtime_error("no response from server");
+
+    return response.body;
+}
+
+//*****************************************************************************
+//*****************************************************************************
+std::map<std::string, RPCEndpointStats> RPCClientPool::stats()
+{
+    LOCK(m_lock);
+    return m_stats;
+}
+
+//*****************************************************************************
+//*****************************************************************************
+void RPCClientPool::clear()
+{
+    LOCK(m_lock);
+    m_idle.clear();
+}
+
+//*****************************************************************************
+//*****************************************************************************
+std::string JSONRPCRequestBody(const std::string & method, const std::string & params,
+                               const int id, const std::string & jsonver)
+{
+    std::string request = "{";
+    if (!jsonver.empty())
+        request += "\"jsonrpc\":" + UniValue(jsonver).write() + ",";
+    request += "\"method\":" + UniValue(method).write() + ",";
+    request += "\"params\":" + params + ",";
+    request += "\"id\":" + std::to_string(id) + "}";
+    return request;
+}
+
+//*****************************************************************************
+//*****************************************************************************
+std::string JSONRPCBatchBody(const std::vector<std::pair<std::string, std::string>> & calls,
+                             const std::string & jsonver)
+{
+    std::string batch = "[";
+    for (size_t i = 0; i < calls.size(); ++i) {
+        if (i > 0)
+            batch += ",";
+        batch += JSONRPCRequestBody(calls[i].first, calls[i].second, static_cast<int>(i), jsonver);
+    }
+    batch += "]";
+    return batch;
+}
+
+//*****************************************************************************
+//*****************************************************************************
+std::vector<UniValue> JSONRPCBatchReplies(const std::string & body, const size_t count)
+{
+    UniValue replies;
+    if (!replies.read(body))
+        throw std::runtime_error(strprintf("expected batch reply from server: %s", body));
+    return JSONRPCSortBatchReplies(replies, count);
+}
+
+//*****************************************************************************
+//*****************************************************************************
+std::vector<UniValue> JSONRPCSortBatchReplies(const UniValue & replies, const size_t count)
+{
+    if (!replies.isArray())
+        throw std::runtime_error(strprintf("expected batch reply from server: %s", replies.write()));
+
+    // Replies may arrive in any order, match them to the requests by id
+    std::vector<UniValue> r(count);
+    for (size_t i = 0; i < replies.size(); ++i) {
+        const UniValue & id = find_value(replies[i], "id");
+        if (!id.isNum() || id.get_int() < 0 || static_cast<size_t>(id.get_int()) >= count)
+            continue;
+        r[id.get_int()] = replies[i];
+    }
+    for (const auto & reply : r) {
+        if (!reply.isObject())
+            throw std::runtime_error(strprintf("missing replies in batch reply from server: %s", replies.write()));
+    }
+    return r;
+}
+
+} // namespace xbridge
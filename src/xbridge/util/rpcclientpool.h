@@ -0,0 +1,141 @@
+// Copyright (c) 2019 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+//*****************************************************************************
+//*****************************************************************************
+
+#ifndef BLOCKNET_XBRIDGE_UTIL_RPCCLIENTPOOL_H
+#define BLOCKNET_XBRIDGE_UTIL_RPCCLIENTPOOL_H
+
+#include <sync.h>
+
+#include <univalue.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//*****************************************************************************
+//*****************************************************************************
+namespace xbridge
+{
+
+/** Idle pooled connections are closed after this many seconds, before the
+ *  server's own idle timeout (-rpcservertimeout defaults to 30 seconds). */
+static const int64_t RPC_POOL_IDLE_TIMEOUT = 15;
+/** Maximum number of idle pooled connections per endpoint. */
+static const size_t RPC_POOL_MAX_IDLE = 8;
+
+/**
+ * Counters for the calls made to an rpc endpoint.
+ */
+struct RPCEndpointStats
+{
+    uint64_t requests{0};
+    uint64_t errors{0};
+    uint64_t connections{0}; // connections opened
+    int64_t totalLatency{0}; // microseconds
+    int64_t maxLatency{0};   // microseconds
+};
+
+/**
+ * Pool of keep-alive http connections used for the JSON-RPC calls made to
+ * wallets and other backends by the xbridge wallet connectors and the
+ * xrouter connectors. Connections are pooled per host:port and reused by
+ * subsequent calls, so a connection (and its host lookup) is only set up
+ * when no idle connection to the endpoint is available.
+ */
+class RPCClientPool
+{
+    class Connection;
+
+public:
+    static RPCClientPool & instance();
+
+    /**
+     * Posts the request body to the endpoint and returns the reply body.
+     * Throws std::runtime_error if the server can't be reached or returns
+     * an http error (other than the status codes JSON-RPC servers use to
+     * report rpc errors).
+     * @param host
+     * @param port
+     * @param user Credentials for basic authentication, none if empty
+     * @param passwd
+     * @param body
+     * @param contenttype Content-Type header, none if empty
+     * @param timeout Seconds
+     * @return
+     */
+    std::string post(const std::string & host, const int port,
+                     const std::string & user, const std::string & passwd,
+                     const std::string & body, const std::string & contenttype,
+                     const int timeout);
+
+    /**
+     * Returns the counters for each endpoint (host:port).
+     * @return
+     */
+    std::map<std::string, RPCEndpointStats> stats();
+
+    /**
+     * Closes the idle connections.
+     */
+    void clear();
+
+private:
+    RPCClientPool() = default;
+
+    std::unique_ptr<Connection> acquire(const std::string & endpoint, const std::string & host, const int port);
+    void release(const std::string & endpoint, std::unique_ptr<Connection> conn);
+
+private:
+    Mutex m_lock;
+    std::map<std::string, std::vector<std::unique_ptr<Connection>>> m_idle GUARDED_BY(m_lock);
+    std::map<std::string, RPCEndpointStats> m_stats GUARDED_BY(m_lock);
+};
+
+/**
+ * Returns a JSON-RPC request.
+ * @param method
+ * @param params Serialized params array
+ * @param id
+ * @param jsonver "jsonrpc" version, omitted if empty
+ * @return
+ */
+std::string JSONRPCRequestBody(const std::string & method, const std::string & params,
+                               const int id, const std::string & jsonver = "");
+
+/**
+ * Returns a JSON-RPC batch request, the id of each request is its index.
+ * @param calls Method and serialized params array of each request
+ * @param jsonver "jsonrpc" version, omitted if empty
+ * @return
+ */
+std::string JSONRPCBatchBody(const std::vector<std::pair<std::string, std::string>> & calls,
+                             const std::string & jsonver = "");
+
+/**
+ * Returns the replies to a JSON-RPC batch request in request order.
+ * Throws std::runtime_error if a reply is missing.
+ * @param body
+ * @param count Number of requests in the batch
+ * @return
+ */
+std::vector<UniValue> JSONRPCBatchReplies(const std::string & body, const size_t count);
+
+/**
+ * Returns the replies to a JSON-RPC batch request in request order.
+ * Throws std::runtime_error if a reply is missing.
+ * @param replies Parsed batch reply
+ * @param count Number of requests in the batch
+ * @return
+ */
+std::vector<UniValue> JSONRPCSortBatchReplies(const UniValue & replies, const size_t count);
+
+} // namespace xbridge
+
+#endif // BLOCKNET_XBRIDGE_UTIL_RPCCLIENTPOOL_H
@@ -5,6 +5,7 @@
 #include <xbridge/util/xseries.h>
 
 #include <chain.h>
+#include <index/tradeindex.h>
 #include <key_io.h>
 #include <validation.h>
 
@@ -12,7 +13,17 @@
 
 //******************************************************************************
 //******************************************************************************
-extern CurrencyPair TxOutToCurrencyPair(const std::vector<CTxOut> & vout, std::string& snode_pubkey); // declared in rpcxbridge.cpp
+CurrencyPair TradeRecordToCurrencyPair(const TradeRecord & record)
+{
+    if (record.IsError())
+        return CurrencyPair{record.error};
+    return CurrencyPair{
+            record.xid,
+            {ccy::Currency{record.fromCurrency,xbridge::TransactionDescr::COIN}, record.fromAmount},
+            {ccy::Currency{record.toCurrency,xbridge::TransactionDescr::COIN}, record.toAmount},
+            boost::posix_time::from_time_t(record.time)
+    };
+}
 
 namespace {
     // Helper functions to filter transactions in a query
@@ -53,38 +64,6 @@ namespace {
             series.at(idx).update(tf == xQuery::Transform::Invert ? it->inverse() : *it, q.with_txids);
         }
     }
-    std::vector<CurrencyPair> get_tradingdata(boost::posix_time::time_period query)
-    {
-        LOCK(cs_main);
-
-        std::vector<CurrencyPair> records;
-
-        CBlockIndex * pindex = chainActive.Tip();
-        auto ts = boost::posix_time::from_time_t(pindex->GetBlockTime());
-        while (pindex->pprev != nullptr && query.end() < ts) {
-            pindex = pindex->pprev;
-            ts = boost::posix_time::from_time_t(pindex->GetBlockTime());
-        }
-
-        for (; pindex->pprev != nullptr && query.contains(ts);
-             pindex = pindex->pprev, ts = boost::posix_time::from_time_t(pindex->GetBlockTime()))
-        {
-            CBlock block;
-            if (not ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-                continue; // throw?
-            for (const CTransactionRef & tx : block.vtx)
-            {
-                std::string snode_pubkey{};
-                CurrencyPair p = TxOutToCurrencyPair(tx->vout, snode_pubkey);
-                if (p.tag == CurrencyPair::Tag::Valid) {
-                    p.timeStamp = ts;
-                    records.emplace_back(p);
-                }
-            }
-        }
-        return records;
-    }
-
     boost::posix_time::ptime get_end_time(int64_t end_secs, boost::posix_time::time_duration cache_granularity) {
         const int64_t psec = cache_granularity.total_seconds();
         if (end_secs < 0 || psec < 1)
@@ -95,6 +74,13 @@ namespace {
         auto epoch_duration = end_time - boost::posix_time::from_time_t(0);
         return get_end_time(epoch_duration.total_seconds(), cache_granularity);
     }
+    template<class Trades> void recompute(xAggregate& x, const Trades& trades) {
+        xAggregate r{x.fromVolume.currency(), x.toVolume.currency()};
+        r.timeEnd = x.timeEnd;
+        for (const auto& t : trades)
+            r.update(t.pair, xQuery::WithTxids::Included);
+        x = r;
+    }
 }
 
 //******************************************************************************
@@ -119,8 +105,15 @@ xSeriesCache::getChainXAggregateSeries(const xQuery& query)
         series[i].timeEnd = t;
     }
 
-    if (not m_cache_period.contains(q.period))
-        updateSeriesCache(q.period);
+    // Wait for the index before taking the cache lock, the cache is
+    // updated on the validation interface queue
+    if (!g_tradeindex)
+        throw std::runtime_error("The trade index is disabled, restart with -tradeindex=1");
+    if (!g_tradeindex->BlockUntilSyncedToCurrentChain())
+        throw std::runtime_error("The trade index is syncing with the chain, try again shortly");
+
+    LOCK(m_xSeriesCacheUpdateLock);
+    updateSeriesCache(q.period);
 
     updateXSeries(series, q.fromCurrency, q.toCurrency,
                   q, xQuery::Transform::None);
@@ -148,27 +141,221 @@ xSeriesCache::getXAggregateContainer(const pairSymbol& key)
 //******************************************************************************
 void xSeriesCache::updateSeriesCache(const boost::posix_time::time_period& period)
 {
-    // TODO(amdn) cached aggregate series for blocks that are purged from the chain
-    // need to be invalidated... this code invalidates on every query to
-    // ensure results are up-to-date, cache can be enabled when invalidation
-    // hook is in place
     LOCK(m_xSeriesCacheUpdateLock);
-    std::vector<CurrencyPair> pairs = get_tradingdata(period);
-    std::sort(pairs.begin(), pairs.end(), // ascending by updated time
-              [](const CurrencyPair& a, const CurrencyPair& b) {
-                  return a.timeStamp < b.timeStamp; });
+    if (!g_tradeindex)
+        return;
+    if (m_cache_tip != nullptr && m_cache_begin <= period.begin())
+        return; // already cached
+
+    // Find the blocks in the period that aren't cached yet, walking back
+    // from the block before the cached range (or from the trade index tip
+    // if nothing is cached). Later blocks are added by BlockConnected.
+    const CBlockIndex * tip = m_cache_tip != nullptr ? m_cache_tip : g_tradeindex->BestBlockIndex();
+    if (tip == nullptr)
+        return;
+
+    int startHeight{0}, endHeight{0};
+    {
+        LOCK(cs_main);
+        const CBlockIndex * pindex = m_cache_tip != nullptr ? tip->GetAncestor(m_cache_start_height - 1) : tip;
+        endHeight = pindex != nullptr ? pindex->nHeight : -1;
+        while (pindex != nullptr && boost::posix_time::from_time_t(pindex->GetBlockTime()) >= period.begin())
+            pindex = pindex->pprev;
+        startHeight = pindex != nullptr ? pindex->nHeight + 1 : 0;
+    }
+
+    std::vector<TradeRecord> trades;
+    if (not g_tradeindex->FindTrades(startHeight, endHeight, trades))
+        return;
+
+    for (const auto & trade : trades) {
+        if (not trade.IsError())
+            addTrade(TradeRecordToCurrencyPair(trade), trade.height);
+    }
+    m_cache_tip = tip;
+    m_cache_start_height = startHeight;
+    m_cache_begin = period.begin();
+}
+
+//******************************************************************************
+//******************************************************************************
+void xSeriesCache::addTrade(const CurrencyPair& p, const int height)
+{
+    const pairSymbol key = p.to.currency().to_string() +"/"+ p.from.currency().to_string();
+    const auto timeEnd = get_end_time(p.timeStamp, m_cache_granularity);
+
+    // Trades are aggregated in time order, a trade from a block with an
+    // earlier timestamp than its predecessor's requires a recompute
+    auto& trades = mSparseTrades[key][timeEnd];
+    auto pos = std::upper_bound(trades.begin(), trades.end(), p,
+                                [height](const CurrencyPair& a, const xTrade& b) {
+                                    return a.timeStamp < b.pair.timeStamp ||
+                                           (a.timeStamp == b.pair.timeStamp && height < b.height); });
+    const bool append = pos == trades.end();
+    trades.insert(pos, xTrade{height, p});
+
+    auto& xac = getXAggregateContainer(key);
+    auto it = std::lower_bound(xac.begin(), xac.end(), timeEnd,
+                               [](const xAggregate& a, const boost::posix_time::ptime& b) {
+                                   return a.timeEnd < b; });
+    if (it == xac.end() || it->timeEnd != timeEnd) {
+        it = xac.emplace(it, xAggregate{p.from.currency(), p.to.currency()});
+        it->timeEnd = timeEnd;
+    }
+    if (append)
+        it->update(p, xQuery::WithTxids::Included);
+    else
+        recompute(*it, trades);
+}
+
+//******************************************************************************
+//******************************************************************************
+void xSeriesCache::removeTrade(const CurrencyPair& p, const int height)
+{
+    const pairSymbol key = p.to.currency().to_string() +"/"+ p.from.currency().to_string();
+    const auto timeEnd = get_end_time(p.timeStamp, m_cache_granularity);
+
+    auto sit = mSparseTrades.find(key);
+    if (sit == mSparseTrades.end())
+        return;
+    auto tit = sit->second.find(timeEnd);
+    if (tit == sit->second.end())
+        return;
+    auto& trades = tit->second;
+    auto pos = std::find_if(trades.begin(), trades.end(), [&p,height](const xTrade& t) {
+        return t.height == height && t.pair.xid() == p.xid(); });
+    if (pos == trades.end())
+        return;
+    trades.erase(pos);
+
+    auto& xac = getXAggregateContainer(key);
+    auto it = std::lower_bound(xac.begin(), xac.end(), timeEnd,
+                               [](const xAggregate& a, const boost::posix_time::ptime& b) {
+                                   return a.timeEnd < b; });
+    if (it == xac.end() || it->timeEnd != timeEnd)
+        return;
+    if (not trades.empty()) {
+        recompute(*it, trades);
+        return;
+    }
+
+    xac.erase(it);
+    sit->second.erase(tit);
+    if (sit->second.empty()) {
+        mSparseTrades.erase(sit);
+        mSparseSeries.erase(key);
+    }
+}
 
+//******************************************************************************
+//******************************************************************************
+void xSeriesCache::trimCache()
+{
+    if (m_cache_tip == nullptr || m_cache_tip->nHeight - m_cache_start_height < MAX_CACHE_BLOCKS + TRIM_CACHE_BLOCKS)
+        return;
+
+    const int startHeight = m_cache_tip->nHeight - MAX_CACHE_BLOCKS;
+    {
+        // Queries starting after the last dropped block are still covered
+        LOCK(cs_main);
+        const CBlockIndex * pindex = m_cache_tip->GetAncestor(startHeight - 1);
+        if (pindex == nullptr)
+            return;
+        const auto begin = boost::posix_time::from_time_t(pindex->GetBlockTime()) + boost::posix_time::seconds{1};
+        if (begin > m_cache_begin)
+            m_cache_begin = begin;
+    }
+    m_cache_start_height = startHeight;
+
+    for (auto sit = mSparseTrades.begin(); sit != mSparseTrades.end(); ) {
+        auto& xac = getXAggregateContainer(sit->first);
+        for (auto tit = sit->second.begin(); tit != sit->second.end(); ) {
+            auto& trades = tit->second;
+            const auto size = trades.size();
+            trades.erase(std::remove_if(trades.begin(), trades.end(), [startHeight](const xTrade& t) {
+                return t.height < startHeight; }), trades.end());
+            if (trades.size() == size) {
+                ++tit;
+                continue;
+            }
+            auto it = std::lower_bound(xac.begin(), xac.end(), tit->first,
+                                       [](const xAggregate& a, const boost::posix_time::ptime& b) {
+                                           return a.timeEnd < b; });
+            const bool found = it != xac.end() && it->timeEnd == tit->first;
+            if (not trades.empty()) {
+                if (found)
+                    recompute(*it, trades);
+                ++tit;
+                continue;
+            }
+            if (found)
+                xac.erase(it);
+            tit = sit->second.erase(tit);
+        }
+        if (sit->second.empty()) {
+            mSparseSeries.erase(sit->first);
+            sit = mSparseTrades.erase(sit);
+        } else {
+            ++sit;
+        }
+    }
+}
+
+//******************************************************************************
+//******************************************************************************
+void xSeriesCache::resetCache()
+{
     mSparseSeries.clear();
-    for (const auto& p : pairs) {
-        pairSymbol key = p.to.currency().to_string() +"/"+ p.from.currency().to_string();
-        auto& q = getXAggregateContainer(key);
-        if (q.empty() || q.back().timeEnd <= p.timeStamp) {
-            q.emplace_back(xAggregate{p.from.currency(), p.to.currency()});
-            q.back().timeEnd = get_end_time(p.timeStamp,m_cache_granularity);
+    mSparseTrades.clear();
+    m_cache_tip = nullptr;
+    m_cache_start_height = 0;
+    m_cache_begin = boost::posix_time::not_a_date_time;
+}
+
+//******************************************************************************
+//******************************************************************************
+void xSeriesCache::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex,
+                                  const std::vector<CTransactionRef>& txnConflicted)
+{
+    LOCK(m_xSeriesCacheUpdateLock);
+    if (m_cache_tip == nullptr)
+        return; // nothing cached yet
+
+    if (pindex->pprev == m_cache_tip) {
+        for (const auto & trade : DecodeTrades(*block, pindex->nHeight)) {
+            if (not trade.IsError())
+                addTrade(TradeRecordToCurrencyPair(trade), trade.height);
         }
-        q.back().update(p,xQuery::WithTxids::Included);
+        m_cache_tip = pindex;
+        trimCache();
+    } else if (m_cache_tip->GetAncestor(pindex->nHeight) != pindex) {
+        // The cache missed a block, it's rebuilt by the next query
+        resetCache();
+    }
+}
+
+//******************************************************************************
+//******************************************************************************
+void xSeriesCache::BlockDisconnected(const std::shared_ptr<const CBlock>& block)
+{
+    LOCK(m_xSeriesCacheUpdateLock);
+    if (m_cache_tip == nullptr)
+        return; // nothing cached yet
+
+    if (block->GetHash() != m_cache_tip->GetBlockHash()) {
+        resetCache();
+        return;
     }
-    m_cache_period = period;
+
+    for (const auto & trade : DecodeTrades(*block, m_cache_tip->nHeight)) {
+        if (not trade.IsError())
+            removeTrade(TradeRecordToCurrencyPair(trade), trade.height);
+    }
+    m_cache_tip = m_cache_tip->pprev;
+
+    // Blocks below the cached range aren't cached
+    if (m_cache_tip == nullptr || m_cache_tip->nHeight < m_cache_start_height - 1)
+        resetCache();
 }
 
 //******************************************************************************
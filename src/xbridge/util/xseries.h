@@ -11,11 +11,13 @@
 #include <chainparams.h>
 #include <key_io.h>
 #include <script/standard.h>
+#include <validationinterface.h>
 
 #include <algorithm>
 #include <cstdint>
 #include <deque>
 #include <limits>
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -26,6 +28,15 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/posix_time/ptime.hpp>
 
+struct TradeRecord;
+
+/**
+ * @brief TradeRecordToCurrencyPair converts a trade index record to currency pair trade details
+ * @param record - trade index record
+ * @return - currency pair trade details
+ */
+CurrencyPair TradeRecordToCurrencyPair(const TradeRecord & record);
+
 /**
  * @brief validate and hold parameters used by dxGetOrderHistory() and others
  */
@@ -190,11 +201,22 @@ public:
 
 /**
  * @brief Cache of open,high,low,close transaction aggregated series
+ *
+ * The cache holds the trades of a contiguous range of blocks ending at the
+ * cache tip. Queries reaching further back than the cache extend it from
+ * the trade index, blocks connected to (and disconnected from) the cache
+ * tip are added to (and retracted from) the cached aggregates. Blocks more
+ * than MAX_CACHE_BLOCKS below the tip are dropped from the cache.
  */
-class xSeriesCache
+class xSeriesCache : public CValidationInterface
 {
 private: // types
     using pairSymbol = std::string;
+    struct xTrade {
+        int height;
+        CurrencyPair pair;
+    };
+    using xTradeContainer = std::vector<xTrade>;
 
 public:
     using xAggregateContainer = std::deque<xAggregate>;
@@ -226,13 +248,29 @@ public:
 
     void updateSeriesCache(const boost::posix_time::time_period&);
 
+protected:
+    // CValidationInterface
+    void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex,
+                        const std::vector<CTransactionRef>& txnConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block) override;
+
 private:
     void updateXSeries(std::vector<xAggregate>& series,
                        const ccy::Currency& from,
                        const ccy::Currency& to,
                        const xQuery& q,
                        xQuery::Transform tf);
+    void addTrade(const CurrencyPair& p, int height);
+    void removeTrade(const CurrencyPair& p, int height);
+    void trimCache();
+    void resetCache();
+
 private:
+    /** Blocks kept in the cache below the tip, about 30 days of blocks */
+    static const int MAX_CACHE_BLOCKS = 43200;
+    /** Blocks the cache may grow past MAX_CACHE_BLOCKS before it's trimmed */
+    static const int TRIM_CACHE_BLOCKS = 1440;
+
     CCriticalSection m_xSeriesCacheUpdateLock;
     /**
      * The cache keeps data in intervals of the minimum of
@@ -243,8 +281,19 @@ private:
     boost::posix_time::time_duration m_cache_granularity{
         std::min(xQuery::min_granularity(), boost::posix_time::time_duration{boost::posix_time::seconds{
                      static_cast<long>(Params().GetConsensus().nPowTargetSpacing)}})};
-    boost::posix_time::time_period m_cache_period{boost::posix_time::ptime{},boost::posix_time::ptime{}};
+    /**
+     * Queries starting at or after m_cache_begin are covered by the blocks
+     * from m_cache_start_height to m_cache_tip (null if nothing is cached).
+     */
+    boost::posix_time::ptime m_cache_begin{boost::posix_time::not_a_date_time};
+    int m_cache_start_height{0};
+    const CBlockIndex* m_cache_tip{nullptr};
     std::unordered_map<pairSymbol, xAggregateContainer> mSparseSeries;
+    /**
+     * Trades in each cached interval ordered by time and height, used to
+     * recompute the interval's aggregate when a block is disconnected.
+     */
+    std::unordered_map<pairSymbol, std::map<boost::posix_time::ptime, xTradeContainer>> mSparseTrades;
 };
 
 #endif // BLOCKNET_XBRIDGE_UTIL_XSERIES_H
@@ -36,6 +36,7 @@
 #include <shutdown.h>
 #include <sync.h>
 #include <ui_interface.h>
+#include <validationinterface.h>
 #include <version.h>
 
 #include <algorithm>
@@ -87,7 +88,10 @@ class App::Impl
 
     enum
     {
-        TIMER_INTERVAL = 15
+        TIMER_INTERVAL = 15,
+        ROUTE_EXPIRY = 3600, // seconds
+        ROUTE_MAX_PEERS = 3, // distinct peers remembered per route
+        ROUTE_MIN_PEERS = 2  // live peers required before a directed packet is not flooded
     };
 
 protected:
@@ -235,6 +239,10 @@ protected:
     typedef std::set<uint256> ProcessedMessages;
     ProcessedMessages                                  m_processedMessages;
 
+    // routes, xbridge address -> distinct peers and the time each relayed to the address
+    CCriticalSection                                   m_routesLock;
+    std::map<std::vector<unsigned char>, std::vector<std::pair<NodeId, int64_t>>> m_routes;
+
     // address book
     CCriticalSection                                   m_addressBookLock;
     AddressBook                                        m_addressBook;
@@ -244,6 +252,7 @@ protected:
     CCriticalSection                                   m_txLocker;
     std::map<uint256, TransactionDescrPtr>             m_transactions;
     std::map<uint256, TransactionDescrPtr>             m_historicTransactions;
+    OrderBook                                          m_orderBook;
     xSeriesCache                                       m_xSeriesCache;
 
     // network packets queue
@@ -390,6 +399,9 @@ bool App::start()
     // Restore local orders
     loadOrders();
 
+    // Keep the trading data series cache in step with the chain
+    RegisterValidationInterface(&m_p->m_xSeriesCache);
+
     return s;
 }
 
@@ -459,6 +471,8 @@ bool App::stop()
         return true;
     m_stopped = true;
 
+    UnregisterValidationInterface(&m_p->m_xSeriesCache);
+
     // Save db state
     saveOrders(true);
 
@@ -581,15 +595,102 @@ void App::Impl::onSend(const std::vector<unsigned char> & id, const std::vector<
     App::instance().addToKnown(hash);
 
     // Relay
+    App::instance().relayPacket(msg);
+}
+
+//*****************************************************************************
+//*****************************************************************************
+void App::relayPacket(const std::vector<unsigned char> & msg, const NodeId from)
+{
+    if (!g_connman || msg.size() < 20)
+        return;
+
+    static const std::vector<unsigned char> zero(20, 0);
+    const std::vector<unsigned char> addr(msg.begin(), msg.begin()+20);
+    const uint256 hash = Hash(msg.begin(), msg.end());
     const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
-    g_connman->ForEachNode([&](CNode* pnode) {
-        if (!pnode->fSuccessfullyConnected)
+
+    auto canRelay = [from](CNode *pnode) -> bool {
+        return pnode->fSuccessfullyConnected && !pnode->fDisconnect
+            && !pnode->fXRouter // do not relay to xrouter nodes
+            && pnode->GetId() != from;
+    };
+
+    // Directed packets are only sent toward the destination if routes through several
+    // distinct peers are known, a single peer could otherwise drop the traffic
+    std::vector<NodeId> routes;
+    if (addr != zero) {
+        LOCK(m_p->m_routesLock);
+        auto it = m_p->m_routes.find(addr);
+        if (it != m_p->m_routes.end()) {
+            const int64_t now = GetTime();
+            auto & peers = it->second;
+            peers.erase(std::remove_if(peers.begin(), peers.end(),
+                [now](const std::pair<NodeId, int64_t> & peer) {
+                    return now - peer.second >= Impl::ROUTE_EXPIRY;
+                }), peers.end());
+            for (const auto & peer : peers)
+                routes.push_back(peer.first);
+            if (peers.empty())
+                m_p->m_routes.erase(it);
+        }
+    }
+    int routed{0};
+    if (routes.size() >= static_cast<size_t>(Impl::ROUTE_MIN_PEERS)) {
+        for (const auto & route : routes) {
+            const bool live = g_connman->ForNode(route, [&](CNode *pnode) -> bool {
+                if (!canRelay(pnode))
+                    return false;
+                if (pnode->AddXBridgeKnown(hash)) {
+                    g_connman->PushMessage(pnode, msgMaker.Make(NetMsgType::XBRIDGE, msg));
+                    ++pnode->nXBridgeSent;
+                    ++pnode->nXBridgeRouted;
+                }
+                return true;
+            });
+            if (live)
+                ++routed;
+        }
+        if (routed >= Impl::ROUTE_MIN_PEERS)
             return;
-        if (pnode->fSuccessfullyConnected && !pnode->fDisconnect && !pnode->fXRouter) // do not relay to xrouter nodes
-            g_connman->PushMessage(pnode, msgMaker.Make(NetMsgType::XBRIDGE, msg));
+    }
+
+    // Broadcasts and packets without a route
+    g_connman->ForEachNode([&](CNode *pnode) {
+        if (!canRelay(pnode) || !pnode->AddXBridgeKnown(hash))
+            return;
+        g_connman->PushMessage(pnode, msgMaker.Make(NetMsgType::XBRIDGE, msg));
+        ++pnode->nXBridgeSent;
     });
 }
 
+//*****************************************************************************
+//*****************************************************************************
+void App::addRoute(const std::vector<unsigned char> & addr, const NodeId peer)
+{
+    if (addr.size() != 20)
+        return;
+    const int64_t now = GetTime();
+    LOCK(m_p->m_routesLock);
+    auto & peers = m_p->m_routes[addr];
+    for (auto & p : peers) {
+        if (p.first == peer) {
+            p.second = now;
+            return;
+        }
+    }
+    if (peers.size() < static_cast<size_t>(Impl::ROUTE_MAX_PEERS)) {
+        peers.emplace_back(peer, now);
+        return;
+    }
+    // Replace the peer that relayed to this address least recently
+    auto oldest = std::min_element(peers.begin(), peers.end(),
+        [](const std::pair<NodeId, int64_t> & a, const std::pair<NodeId, int64_t> & b) {
+            return a.second < b.second;
+        });
+    *oldest = std::make_pair(peer, now);
+}
+
 //*****************************************************************************
 //*****************************************************************************
 void App::sendPacket(const std::vector<unsigned char> & id, const XBridgePacketPtr & packet)
@@ -1301,6 +1402,25 @@ std::map<uint256, xbridge::TransactionDescrPtr> App::transactions() const
     return m_p->m_transactions;
 }
 
+//******************************************************************************
+//******************************************************************************
+std::vector<OrderBook::Level> App::orderBook(const std::string & fromCurrency, const std::string & toCurrency,
+                                             const size_t maxLevels, const size_t maxOrders) const
+{
+    LOCK(m_p->m_txLocker);
+    return m_p->m_orderBook.levels(fromCurrency, toCurrency, maxLevels, maxOrders);
+}
+
+//******************************************************************************
+//******************************************************************************
+void App::updateOrderBook(const TransactionDescrPtr & ptr)
+{
+    LOCK(m_p->m_txLocker);
+    auto it = m_p->m_transactions.find(ptr->id);
+    if (it != m_p->m_transactions.end())
+        m_p->m_orderBook.add(it->second);
+}
+
 //******************************************************************************
 //******************************************************************************
 std::map<uint256, xbridge::TransactionDescrPtr> App::history() const
@@ -1343,6 +1463,7 @@ App::flushCancelledOrders(bpt::time_duration minAge) const
             if (ptr->state == xbridge::TransactionDescr::trCancelled
                 && ptr->txtime < keepTime) {
                 list.emplace_back(ptr->id,ptr->txtime,ptr.use_count());
+                m_p->m_orderBook.remove(ptr->id);
                 mp->erase(it++);
             } else {
                 ++it;
@@ -1368,6 +1489,7 @@ void App::appendTransaction(const TransactionDescrPtr & ptr)
     {
         // new transaction, copy data
         m_p->m_transactions[ptr->id] = ptr;
+        m_p->m_orderBook.add(ptr);
     }
     else
     {
@@ -1392,6 +1514,7 @@ void App::moveTransactionToHistory(const uint256 & id)
             xtx = m_p->m_transactions[id];
 
             counter = m_p->m_transactions.erase(id);
+            m_p->m_orderBook.remove(id);
             if(counter > 1) {
                 ERR() << "duplicate order id = " << id.GetHex() << " " << __FUNCTION__;
             }
@@ -1965,6 +2088,7 @@ xbridge::Error App::sendXBridgeTransaction(const std::string & from,
     {
         LOCK(m_p->m_txLocker);
         m_p->m_transactions[id] = ptr;
+        m_p->m_orderBook.add(ptr);
     }
 
     return xbridge::Error::SUCCESS;
@@ -2060,11 +2184,13 @@ Error App::acceptXBridgeTransaction(const uint256 & id, const std::string & from
     ptr->state = TransactionDescr::trAccepting;
     ptr->fromAmount = fromSize;
     ptr->toAmount = toSize;
+    updateOrderBook(ptr);
 
-    auto revertOrder = [priorState](TransactionDescrPtr & ptr){
+    auto revertOrder = [this,priorState](TransactionDescrPtr & ptr){
         ptr->state = priorState;
         ptr->fromAmount = ptr->origFromAmount;
         ptr->toAmount = ptr->origToAmount;
+        updateOrderBook(ptr);
     };
 
     WalletConnectorPtr connFrom = connectorByCurrency(ptr->fromCurrency);
@@ -3543,6 +3669,7 @@ void App::Impl::checkAndEraseExpiredTransactions()
         for (const uint256 & id : forErase)
         {
             m_transactions.erase(id);
+            m_orderBook.remove(id);
         }
     }
     // ...and notify
@@ -3717,6 +3844,7 @@ void App::clearNonLocalOrders() {
         }
         LOCK(m_p->m_connectorsLock);
         if (!m_p->m_connectorCurrencyMap.count(ptr->fromCurrency) || !m_p->m_connectorCurrencyMap.count(ptr->toCurrency)) {
+            m_p->m_orderBook.remove(ptr->id);
             m_p->m_transactions.erase(it++);
         } else {
             ++it;
@@ -3751,8 +3879,8 @@ void App::loadOrders() {
         // Restore all transactions
         if (tr->state == TransactionDescr::trCancelled || tr->state == TransactionDescr::trFinished || tr->isHistorical())
             m_p->m_historicTransactions.insert(std::make_pair(tr->id, tr));
-        else
-            m_p->m_transactions.insert(std::make_pair(tr->id, tr));
+        else if (m_p->m_transactions.insert(std::make_pair(tr->id, tr)).second)
+            m_p->m_orderBook.add(tr);
 
         // Restore spent deposit watches
         if (tr->isWatchingForSpentDeposit())
@@ -12,12 +12,14 @@
 #include <xbridge/util/xutil.h>
 #include <xbridge/xbridgedb.h>
 #include <xbridge/xbridgedef.h>
+#include <xbridge/xbridgeorderbook.h>
 #include <xbridge/xbridgepacket.h>
 #include <xbridge/xbridgetransactiondescr.h>
 #include <xbridge/xbridgewalletconnector.h>
 
 #include <amount.h>
 #include <consensus/validation.h>
+#include <net.h>
 #include <primitives/transaction.h>
 #include <uint256.h>
 #ifdef ENABLE_WALLET
@@ -189,6 +191,23 @@ public:
      * @return map of all transaction
      */
     std::map<uint256, xbridge::TransactionDescrPtr> transactions() const;
+    /**
+     * @brief orderBook - open orders selling fromCurrency for toCurrency grouped
+     * by price, lowest price first
+     * @param fromCurrency
+     * @param toCurrency
+     * @param maxLevels maximum price levels, 0 for no limit
+     * @param maxOrders maximum orders across all levels, 0 for no limit
+     * @return
+     */
+    std::vector<OrderBook::Level> orderBook(const std::string & fromCurrency, const std::string & toCurrency,
+                                            size_t maxLevels, size_t maxOrders) const;
+    /**
+     * @brief updateOrderBook - moves the open order to its current price, call after
+     * the order's amounts change
+     * @param ptr
+     */
+    void updateOrderBook(const TransactionDescrPtr & ptr);
     /**
      * @brief history
      * @return map of historical transaction (local canceled and finished)
@@ -488,6 +507,23 @@ public:
      */
     void sendPacket(const std::vector<unsigned char> & id, const XBridgePacketPtr & packet);
 
+    /**
+     * @brief relayPacket - relay xbridge network packet (address, timestamp and body) to peers.
+     * Packets addressed to a destination with routes through at least two live peers are sent
+     * to those peers only, all other packets are sent to every peer that doesn't have the packet yet.
+     * @param msg
+     * @param from peer the packet was received from, -1 if the packet originated here
+     */
+    void relayPacket(const std::vector<unsigned char> & msg, NodeId from = -1);
+    /**
+     * @brief addRoute - record a peer that relayed traffic from the specified xbridge address,
+     * e.g. a servicenode ping. Up to three distinct peers are kept per address, a new peer
+     * replaces the one that relayed least recently. Directed packets are routed to these peers
+     * @param addr
+     * @param peer
+     */
+    void addRoute(const std::vector<unsigned char> & addr, NodeId peer);
+
     // call when message from xbridge network received
     /**
      * @brief onMessageReceived  call when message from xbridge network received
@@ -0,0 +1,112 @@
+// Copyright (c) 2019 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+//******************************************************************************
+//******************************************************************************
+
+#include <xbridge/xbridgeorderbook.h>
+
+#include <xbridge/util/xutil.h>
+#include <xbridge/xbridgetransactiondescr.h>
+
+#include <cmath>
+#include <limits>
+
+#include <boost/algorithm/string.hpp>
+
+//******************************************************************************
+//******************************************************************************
+namespace xbridge
+{
+
+// floating point comparisons
+// see Knuth 4.2.2 Eq 36
+static bool samePrice(const double a, const double b)
+{
+    const auto epsilon = std::numeric_limits<double>::epsilon();
+    return (fabs(a - b) / fabs(a) <= epsilon) && (fabs(a - b) / fabs(b) <= epsilon);
+}
+
+//******************************************************************************
+//******************************************************************************
+OrderBook::Market OrderBook::market(const std::string & fromCurrency, const std::string & toCurrency)
+{
+    return std::make_pair(boost::to_upper_copy(fromCurrency), boost::to_upper_copy(toCurrency));
+}
+
+//******************************************************************************
+//******************************************************************************
+void OrderBook::add(const TransactionDescrPtr & order)
+{
+    if (!order)
+        return;
+
+    remove(order->id);
+
+    Entry entry{market(order->fromCurrency, order->toCurrency), price(order), order};
+    m_markets[entry.market].emplace(entry.price, order->id);
+    m_entries.emplace(order->id, std::move(entry));
+}
+
+//******************************************************************************
+//******************************************************************************
+void OrderBook::remove(const uint256 & id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+        return;
+
+    auto mit = m_markets.find(it->second.market);
+    if (mit != m_markets.end()) {
+        mit->second.erase(std::make_pair(it->second.price, id));
+        if (mit->second.empty())
+            m_markets.erase(mit);
+    }
+    m_entries.erase(it);
+}
+
+//******************************************************************************
+//******************************************************************************
+void OrderBook::clear()
+{
+    m_entries.clear();
+    m_markets.clear();
+}
+
+//******************************************************************************
+//******************************************************************************
+std::vector<OrderBook::Level> OrderBook::levels(const std::string & fromCurrency, const std::string & toCurrency,
+                                                const size_t maxLevels, const size_t maxOrders) const
+{
+    std::vector<Level> result;
+
+    auto mit = m_markets.find(market(fromCurrency, toCurrency));
+    if (mit == m_markets.end())
+        return result;
+
+    const auto & prices = mit->second;
+    size_t orders{0};
+
+    for (const auto & p : prices) {
+        const auto & entry = m_entries.at(p.second);
+        const auto & order = entry.order;
+
+        if (order->state != TransactionDescr::trPending || order->fromAmount <= 0 || order->toAmount <= 0)
+            continue;
+
+        if (result.empty() || !samePrice(result.back().price, entry.price)) {
+            if (maxLevels > 0 && result.size() >= maxLevels)
+                break;
+            result.push_back(Level{entry.price, {}});
+        }
+
+        result.back().orders.push_back(order);
+        if (maxOrders > 0 && ++orders >= maxOrders)
+            break;
+    }
+
+    return result;
+}
+
+} // namespace xbridge
@@ -0,0 +1,101 @@
+// Copyright (c) 2019 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+//******************************************************************************
+//******************************************************************************
+
+#ifndef BLOCKNET_XBRIDGE_XBRIDGEORDERBOOK_H
+#define BLOCKNET_XBRIDGE_XBRIDGEORDERBOOK_H
+
+#include <xbridge/xbridgedef.h>
+
+#include <uint256.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+//******************************************************************************
+//******************************************************************************
+namespace xbridge
+{
+
+/**
+ * @brief Open orders indexed by market (maker and taker currency) and price.
+ * Orders are added when they enter the order list and removed when they
+ * leave it. Orders whose amounts change must be added again to move them to
+ * their new price. Order state changes in place, orders that aren't open are
+ * skipped when read. Not thread safe, the owner's transaction lock guards it.
+ */
+class OrderBook
+{
+public:
+    /**
+     * @brief Orders at the same price, price is the taker amount per maker amount.
+     */
+    struct Level
+    {
+        double                           price;
+        std::vector<TransactionDescrPtr> orders;
+    };
+
+public:
+    /**
+     * @brief add - Adds the order or updates its price.
+     * @param order
+     */
+    void add(const TransactionDescrPtr & order);
+
+    /**
+     * @brief remove - Removes the order.
+     * @param id
+     */
+    void remove(const uint256 & id);
+
+    /**
+     * @brief clear - Removes all orders.
+     */
+    void clear();
+
+    /**
+     * @brief levels - Returns the open orders selling fromCurrency for toCurrency
+     * grouped by price, lowest price first. Currencies are case insensitive.
+     * @param fromCurrency
+     * @param toCurrency
+     * @param maxLevels maximum price levels to return, 0 for no limit
+     * @param maxOrders maximum orders to return across all levels, 0 for no limit
+     * @return
+     */
+    std::vector<Level> levels(const std::string & fromCurrency, const std::string & toCurrency,
+                              size_t maxLevels, size_t maxOrders) const;
+
+    /**
+     * @brief size - Returns the number of indexed orders.
+     * @return
+     */
+    size_t size() const { return m_entries.size(); }
+
+private:
+    typedef std::pair<std::string, std::string> Market;
+    typedef std::set<std::pair<double, uint256>> Prices;
+
+    struct Entry
+    {
+        Market              market;
+        double              price;
+        TransactionDescrPtr order;
+    };
+
+    static Market market(const std::string & fromCurrency, const std::string & toCurrency);
+
+private:
+    std::map<uint256, Entry> m_entries;
+    std::map<Market, Prices> m_markets;
+};
+
+} // namespace xbridge
+
+#endif // BLOCKNET_XBRIDGE_XBRIDGEORDERBOOK_H
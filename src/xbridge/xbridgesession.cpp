@@ -1524,6 +1524,7 @@ bool Session::Impl::processTransactionHold(XBridgePacketPtr packet) const
     if (xtx->role == 'A') {
         xtx->fromAmount = damount;
         xtx->toAmount = samount;
+        xapp.updateOrderBook(xtx);
     }
 
     xtx->state = TransactionDescr::trHold;
@@ -3446,6 +3447,7 @@ bool Session::Impl::processTransactionReject(XBridgePacketPtr packet) const
     xtx->toCurrency = xtx->origToCurrency;
     xtx->fromAmount = xtx->origFromAmount;
     xtx->toAmount = xtx->origToAmount;
+    xapp.updateOrderBook(xtx);
     // remove from pending packets (if added)
     xapp.removePackets(txid);
 
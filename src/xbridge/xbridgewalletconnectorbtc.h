@@ -8,12 +8,11 @@
 #ifndef BLOCKNET_XBRIDGE_XBRIDGEWALLETCONNECTORBTC_H
 #define BLOCKNET_XBRIDGE_XBRIDGEWALLETCONNECTORBTC_H
 
+#include <xbridge/util/rpcclientpool.h>
 #include <xbridge/xbridgewalletconnector.h>
 
-#include <event2/buffer.h>
 #include <rpc/protocol.h>
 #include <rpc/client.h>
-#include <support/events.h>
 #include <tinyformat.h>
 #include <util/strencodings.h>
 #include <util/system.h>
@@ -31,82 +30,6 @@
 //*****************************************************************************
 namespace xbridge
 {
-    /** Reply structure for request_done to fill in */
-    struct HTTPReply
-    {
-        HTTPReply(): status(0), error(-1) {}
-
-        int status;
-        int error;
-        std::string body;
-    };
-
-    static const char *http_errorstring(int code)
-    {
-        switch(code) {
-    #if LIBEVENT_VERSION_NUMBER >= 0x02010300
-        case EVREQ_HTTP_TIMEOUT:
-            return "timeout reached";
-        case EVREQ_HTTP_EOF:
-            return "EOF reached";
-        case EVREQ_HTTP_INVALID_HEADER:
-            return "error while reading header, or invalid header";
-        case EVREQ_HTTP_BUFFER_ERROR:
-            return "error encountered while reading or writing";
-        case EVREQ_HTTP_REQUEST_CANCEL:
-            return "request was canceled";
-        case EVREQ_HTTP_DATA_TOO_LONG:
-            return "response body is larger than allowed";
-    #endif
-        default:
-            return "unknown";
-        }
-    }
-
-    static void http_request_done(struct evhttp_request *req, void *ctx)
-    {
-        HTTPReply *reply = static_cast<HTTPReply*>(ctx);
-
-        if (req == nullptr) {
-            /* If req is nullptr, it means an error occurred while connecting: the
-             * error code will have been passed to http_error_cb.
-             */
-            reply->status = 0;
-            return;
-        }
-
-        reply->status = evhttp_request_get_response_code(req);
-
-        struct evbuffer *buf = evhttp_request_get_input_buffer(req);
-        if (buf)
-        {
-            size_t size = evbuffer_get_length(buf);
-            const char *data = (const char*)evbuffer_pullup(buf, size);
-            if (data)
-                reply->body = std::string(data, size);
-            evbuffer_drain(buf, size);
-        }
-    }
-
-#if LIBEVENT_VERSION_NUMBER >= 0x02010300
-    static void http_error_cb(enum evhttp_request_error err, void *ctx)
-    {
-        HTTPReply *reply = static_cast<HTTPReply*>(ctx);
-        reply->error = err;
-    }
-#endif
-
-static UniValue XBridgeJSONRPCRequestObj(const std::string& strMethod, const UniValue& params,
-        const UniValue& id, const std::string& jsonver="")
-{
-    UniValue request(UniValue::VOBJ);
-    if (!jsonver.empty())
-        request.pushKV("jsonrpc", jsonver);
-    request.pushKV("method", strMethod);
-    request.pushKV("params", params);
-    request.pushKV("id", id);
-    return request;
-}
 
 static json_spirit::Object CallRPC(const std::string & rpcuser, const std::string & rpcpasswd,
                       const std::string & rpcip, const std::string & rpcport,
@@ -116,71 +39,14 @@ static json_spirit::Object CallRPC(const std::string & rpcuser, const std::strin
     const std::string & host = rpcip;
     const int port = boost::lexical_cast<int>(rpcport);
 
-    // Obtain event base
-    raii_event_base base = obtain_event_base();
-
-    // Synchronously look up hostname
-    raii_evhttp_connection evcon = obtain_evhttp_connection_base(base.get(), host, port);
-    evhttp_connection_set_timeout(evcon.get(), gArgs.GetArg("-rpcxbridgetimeout", 120));
-
-    HTTPReply response;
-    raii_evhttp_request req = obtain_evhttp_request(http_request_done, (void*)&response);
-    if (req == nullptr)
-        throw std::runtime_error("create http request failed");
-#if LIBEVENT_VERSION_NUMBER >= 0x02010300
-    evhttp_request_set_error_cb(req.get(), http_error_cb);
-#endif
-
-    struct evkeyvalq* output_headers = evhttp_request_get_output_headers(req.get());
-    assert(output_headers);
-    evhttp_add_header(output_headers, "Host", host.c_str());
-    evhttp_add_header(output_headers, "Connection", "close");
-    // Set content type
-    if (!contenttype.empty())
-        evhttp_add_header(output_headers, "Content-Type", contenttype.c_str());
-    // Set credentials
-    if (!rpcuser.empty() || !rpcpasswd.empty()) {
-        std::string strRPCUserColonPass = rpcuser + ":" + rpcpasswd;
-        evhttp_add_header(output_headers, "Authorization", (std::string("Basic ") + EncodeBase64(strRPCUserColonPass)).c_str());
-    }
-
-    // Attach request data
-    const auto tostring = json_spirit::write_string(json_spirit::Value(params), json_spirit::none, 8);
-    UniValue toval;
-    if (!toval.read(tostring))
-        throw std::runtime_error(strprintf("failed to decode json_spirit data: %s", tostring));
-    const auto reqobj = XBridgeJSONRPCRequestObj(strMethod, toval.get_array(), 1, jsonver);
-    std::string strRequest = reqobj.write() + "\n";
-    struct evbuffer* output_buffer = evhttp_request_get_output_buffer(req.get());
-    assert(output_buffer);
-    evbuffer_add(output_buffer, strRequest.data(), strRequest.size());
-
-    // check if we should use a special wallet endpoint
-    std::string endpoint = "/";
-    int r = evhttp_make_request(evcon.get(), req.get(), EVHTTP_REQ_POST, endpoint.c_str());
-    req.release(); // ownership moved to evcon in above call
-    if (r != 0) {
-        throw std::runtime_error("send http request failed");
-    }
-
-    event_base_dispatch(base.get());
-
-    if (response.status == 0) {
-        std::string responseErrorMessage;
-        if (response.error != -1) {
-            responseErrorMessage = strprintf(" (error code %d - \"%s\")", response.error, http_errorstring(response.error));
-        }
-        throw std::runtime_error(strprintf("Could not connect to the server %s:%d%s\n\nMake sure the blocknetd server is running and that you are connecting to the correct RPC port.", host, port, responseErrorMessage));
-    } else if (response.status == HTTP_UNAUTHORIZED) {
-        throw std::runtime_error("Authorization failed: Incorrect rpcuser or rpcpassword");
-    } else if (response.status >= 400 && response.status != HTTP_BAD_REQUEST && response.status != HTTP_NOT_FOUND && response.status != HTTP_INTERNAL_SERVER_ERROR)
-        throw std::runtime_error(strprintf("server returned HTTP error %d", response.status));
-    else if (response.body.empty())
-        throw std::runtime_error("no response from server");
+    const auto strParams = json_spirit::write_string(json_spirit::Value(params), json_spirit::none, 8);
+    const auto strReply = RPCClientPool::instance().post(host, port, rpcuser, rpcpasswd,
+            JSONRPCRequestBody(strMethod, strParams, 1, jsonver), contenttype,
+            static_cast<int>(gArgs.GetArg("-rpcxbridgetimeout", 120)));
 
     // Parse reply
     json_spirit::Value valReply;
-    if (!json_spirit::read_string(response.body, valReply))
+    if (!json_spirit::read_string(strReply, valReply))
         throw std::runtime_error("couldn't parse reply from server");
     const json_spirit::Object& reply = valReply.get_obj();
     if (reply.empty())
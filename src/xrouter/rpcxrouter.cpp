@@ -4,6 +4,7 @@
 
 #include <rpc/server.h>
 
+#include <servicenode/servicenodemgr.h>
 #include <xbridge/xbridgeapp.h>
 #include <xrouter/xrouterapp.h>
 #include <xrouter/xroutererror.h>
@@ -1341,7 +1342,38 @@ static UniValue xrStatus(const JSONRPCRequest& request)
     {
       "xrouter": true,
       "servicenode": false,
-      "config": "[Main]\ntimeout=30\nconsensus=1\nmaxfee=0.5"
+      "config": "[Main]\ntimeout=30\nconsensus=1\nmaxfee=0.5",
+      "plugins": {},
+      "rpcendpoints": {
+        "127.0.0.1:8332": {
+          "requests": 120,
+          "errors": 0,
+          "connections": 2,
+          "avglatency": 1.25,
+          "maxlatency": 9.5
+        }
+      },
+      "connectors": {
+        "BTC": {
+          "maxconcurrent": 4,
+          "active": 1,
+          "queued": 0,
+          "served": 40,
+          "rejected": 0,
+          "avgwait": 0.3,
+          "maxwait": 12.1,
+          "avgservice": 3.2,
+          "maxservice": 25.8
+        }
+      },
+      "replycache": {
+        "entries": 310,
+        "bytes": 1048576,
+        "maxbytes": 33554432,
+        "hits": 1200,
+        "misses": 340,
+        "evictions": 0
+      }
     }
 
     Key          | Type | Description
@@ -1353,6 +1385,19 @@ static UniValue xrStatus(const JSONRPCRequest& request)
                  |      | true: Client is a Service Node.
                  |      | false: Client is not a Service Node.
     config       | str  | The raw text contents of your xrouter.conf.
+    plugins      | obj  | The raw text contents of each plugin config.
+    rpcendpoints | obj  | Calls made to each wallet rpc endpoint (host:port):
+                 |      | requests, errors, connections opened and the
+                 |      | average and maximum latency in milliseconds.
+    connectors   | obj  | Service Nodes only. Client requests scheduled on
+                 |      | each wallet: concurrency limit, requests running
+                 |      | and queued, requests served and rejected, and the
+                 |      | average and maximum queue wait and service time in
+                 |      | milliseconds.
+    replycache   | obj  | Service Nodes only. Wallet replies cached for
+                 |      | repeated client requests: entries and memory used,
+                 |      | memory cap, cache hits and misses, and entries
+                 |      | evicted to stay under the cap.
                 )"
                 },
                 RPCExamples{
@@ -1797,7 +1842,7 @@ static UniValue xrUpdateNetworkServices(const JSONRPCRequest& request) {
                 if (pnode->GetAddrName() != addr)
                     return;
                 const CNetMsgMaker msgMaker(pnode->GetSendVersion());
-                g_connman->PushMessage(pnode, msgMaker.Make(NetMsgType::SNLIST));
+                g_connman->PushMessage(pnode, msgMaker.Make(NetMsgType::SNLIST, sn::ServiceNodeListCursor()));
             });
         } catch (...) {
             break;
@@ -6,6 +6,8 @@
 
 #include <xrouter/xrouterdef.h>
 
+#include <xbridge/util/rpcclientpool.h>
+
 #include <event2/buffer.h>
 #include <rpc/protocol.h>
 #include <support/events.h>
@@ -110,18 +112,6 @@ static void http_error_cb(enum evhttp_request_error err, void *ctx)
 }
 #endif
 
-UniValue XRouterJSONRPCRequestObj(const std::string& strMethod, const UniValue& params,
-        const UniValue& id, const std::string& jsonver="")
-{
-    UniValue request(UniValue::VOBJ);
-    if (!jsonver.empty())
-        request.pushKV("jsonrpc", jsonver);
-    request.pushKV("method", strMethod);
-    request.pushKV("params", params);
-    request.pushKV("id", id);
-    return request;
-}
-
 std::string CallRPC(const std::string & rpcip, const std::string & rpcport, const std::string & strMethod,
                     const Array & params, const std::string & jsonver, const std::string & contenttype)
 {
@@ -133,70 +123,44 @@ std::string CallRPC(const std::string & rpcuser, const std::string & rpcpasswd,
                       const std::string & strMethod, const json_spirit::Array & params,
                       const std::string & jsonver, const std::string & contenttype)
 {
-    const std::string & host = rpcip;
     const int port = boost::lexical_cast<int>(rpcport);
+    const auto strParams = json_spirit::write_string(json_spirit::Value(params), json_spirit::none, 8);
+    return xbridge::RPCClientPool::instance().post(rpcip, port, rpcuser, rpcpasswd,
+            xbridge::JSONRPCRequestBody(strMethod, strParams, 1, jsonver), contenttype,
+            static_cast<int>(gArgs.GetArg("-rpcxroutertimeout", 60)));
+}
 
-    // Obtain event base
-    raii_event_base base = obtain_event_base();
-
-    // Synchronously look up hostname
-    raii_evhttp_connection evcon = obtain_evhttp_connection_base(base.get(), host, port);
-    evhttp_connection_set_timeout(evcon.get(), gArgs.GetArg("-rpcxroutertimeout", 60));
-
-    HTTPReply response;
-    raii_evhttp_request req = obtain_evhttp_request(http_request_done, (void*)&response);
-    if (req == nullptr)
-        throw std::runtime_error("create http request failed");
-#if LIBEVENT_VERSION_NUMBER >= 0x02010300
-    evhttp_request_set_error_cb(req.get(), http_error_cb);
-#endif
-
-    struct evkeyvalq* output_headers = evhttp_request_get_output_headers(req.get());
-    assert(output_headers);
-    evhttp_add_header(output_headers, "Host", host.c_str());
-    evhttp_add_header(output_headers, "Connection", "close");
-    // Set content type
-    if (!contenttype.empty())
-        evhttp_add_header(output_headers, "Content-Type", contenttype.c_str());
-    // Set credentials
-    if (!rpcuser.empty() || !rpcpasswd.empty()) {
-        std::string strRPCUserColonPass = rpcuser + ":" + rpcpasswd;
-        evhttp_add_header(output_headers, "Authorization", (std::string("Basic ") + EncodeBase64(strRPCUserColonPass)).c_str());
-    }
-
-    // Attach request data
-    const auto tostring = json_spirit::write_string(json_spirit::Value(params), json_spirit::none, 8);
-    UniValue toval;
-    if (!toval.read(tostring))
-        throw std::runtime_error(strprintf("failed to decode json_spirit data: %s", tostring));
-    const auto reqobj = XRouterJSONRPCRequestObj(strMethod, toval.get_array(), 1, jsonver);
-    std::string strRequest = reqobj.write() + "\n";
-    struct evbuffer* output_buffer = evhttp_request_get_output_buffer(req.get());
-    assert(output_buffer);
-    evbuffer_add(output_buffer, strRequest.data(), strRequest.size());
-
-    int r = evhttp_make_request(evcon.get(), req.get(), EVHTTP_REQ_POST, "/");
-    req.release(); // ownership moved to evcon in above call
-    if (r != 0) {
-        throw std::runtime_error("send http request failed");
-    }
-
-    event_base_dispatch(base.get());
+bool CallRPCBatch(const std::string & rpcuser, const std::string & rpcpasswd,
+                  const std::string & rpcip, const std::string & rpcport,
+                  const std::vector<std::pair<std::string, json_spirit::Array>> & calls,
+                  std::vector<std::string> & replies,
+                  const std::string & jsonver, const std::string & contenttype)
+{
+    replies.clear();
+    if (calls.empty())
+        return true;
 
-    if (response.status == 0) {
-        std::string responseErrorMessage;
-        if (response.error != -1) {
-            responseErrorMessage = strprintf(" (error code %d - \"%s\")", response.error, http_errorstring(response.error));
-        }
-        throw std::runtime_error(strprintf("Could not connect to the server %s:%d%s\n\nMake sure the blocknetd server is running and that you are connecting to the correct RPC port.", host, port, responseErrorMessage));
-    } else if (response.status == HTTP_UNAUTHORIZED) {
-        throw std::runtime_error("Authorization failed: Incorrect rpcuser or rpcpassword");
-    } else if (response.status >= 400 && response.status != HTTP_BAD_REQUEST && response.status != HTTP_NOT_FOUND && response.status != HTTP_INTERNAL_SERVER_ERROR)
-        throw std::runtime_error(strprintf("server returned HTTP error %d: %s", response.status, response.body));
-    else if (response.body.empty())
-        throw std::runtime_error("no response from server");
+    std::vector<std::pair<std::string, std::string>> requests;
+    requests.reserve(calls.size());
+    for (const auto & call : calls)
+        requests.emplace_back(call.first, json_spirit::write_string(json_spirit::Value(call.second), json_spirit::none, 8));
 
-    return response.body;
+    const int port = boost::lexical_cast<int>(rpcport);
+    const auto body = xbridge::RPCClientPool::instance().post(rpcip, port, rpcuser, rpcpasswd,
+            xbridge::JSONRPCBatchBody(requests, jsonver), contenttype,
+            static_cast<int>(gArgs.GetArg("-rpcxroutertimeout", 60)));
+
+    UniValue batch;
+    if (!batch.read(body))
+        throw std::runtime_error(strprintf("invalid batch reply from server: %s", body));
+    if (!batch.isArray())
+        return false; // a single reply (usually an error) to the whole batch, batches aren't supported
+
+    const auto values = xbridge::JSONRPCSortBatchReplies(batch, calls.size());
+    replies.reserve(values.size());
+    for (const auto & reply : values)
+        replies.push_back(reply.write());
+    return true;
 }
 
 XRouterReply CallXRouterUrl(const std::string & host, const int & port, const std::string & url, const std::string & data,
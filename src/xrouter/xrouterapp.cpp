@@ -7,6 +7,8 @@
 #include <xrouter/xroutererror.h>
 #include <xrouter/xrouterlogger.h>
 
+#include <xbridge/util/rpcclientpool.h>
+
 #include <addrman.h>
 #include <bloom.h>
 #include <keystore.h>
@@ -17,6 +19,7 @@
 #include <univalue.h>
 
 #include <chrono>
+#include <functional>
 #include <iostream>
 #include <vector>
 
@@ -163,6 +166,10 @@ bool App::start()
     } else if (!initKeyPair()) // init on regular xrouter clients (non-snodes)
         return false;
 
+    requestQueue.start(XROUTER_REQUEST_THREADS);
+    // Client calls hold a worker until the reply, workers are added as calls need them
+    clientRequestQueue.start(1, std::min(std::max(xrsettings->clientRequestThreads(), 1), XROUTER_MAX_CLIENT_REQUEST_THREADS));
+
     {
         LOCK(mu);
         xrouterIsReady = true;
@@ -592,8 +599,8 @@ bool App::stop(const bool safeCleanup)
         return false;
 
     // shutdown threads
-    requestHandlers.interrupt_all();
-    requestHandlers.join_all();
+    requestQueue.stop();
+    clientRequestQueue.stop();
 
     if (server && !server->stop())
         return false;
@@ -921,8 +928,8 @@ bool App::processConfigMessage(const sn::ServiceNode & snode) {
         std::map<std::string, UniValue> kv; plugins.getObjMap(kv);
         for (const auto & item : kv) {
             const auto & plugin = item.first;
-            const auto & config = item.second.get_str();
             try {
+                const auto & config = item.second.get_str();
                 auto psettings = std::make_shared<XRouterPluginSettings>(false); // not our config
                 psettings->read(config);
                 // Exclude open tier paid services
@@ -945,26 +952,16 @@ void App::onMessageReceived(CNode* node, const std::vector<unsigned char> & mess
     if (!isEnabled() || !isReady())
         return;
 
-    auto retainNode = [](CNode *pnode) {
-        pnode->AddRef();
-    };
-
-    retainNode(node); // retain for thread below
+    // Retain the node until the request is processed or dropped
+    node->AddRef();
+    std::shared_ptr<CNode> nodeRef(node, [](CNode *pnode) { pnode->Release(); });
 
-    // Handle the xrouter request
-    requestHandlers.create_thread([this, node, message]() {
-        RenameThread("blocknet-xrrequest");
-        boost::this_thread::interruption_point();
+    // Handle the xrouter request on the request queue, requests are dropped
+    // when the peer (or all peers) have too many requests in flight
+    const bool queued = requestQueue.push(node->GetId(), [this, nodeRef, message]() {
+        CNode *node = nodeRef.get();
         CValidationState state;
 
-        bool released{false};
-        auto releaseNode = [&released](CNode *pnode) {
-            if (!released) {
-                released = true;
-                pnode->Release();
-            }
-        };
-
         try {
             XRouterPacketPtr packet(new XRouterPacket);
             if (!packet->copyFrom(message)) {
@@ -988,8 +985,6 @@ void App::onMessageReceived(CNode* node, const std::vector<unsigned char> & mess
                 checkSnodeBan(node->GetAddrName(), queryMgr.updateScore(node->GetAddrName(), -10));
                 state.DoS(10, error("XRouter: invalid packet received"), REJECT_INVALID, "xrouter-error");
                 checkDoS(state, node);
-                releaseNode(node);
-
                 return;
             }
 
@@ -1015,24 +1010,35 @@ void App::onMessageReceived(CNode* node, const std::vector<unsigned char> & mess
                 processConfigReply(node, packet, state);
             } else if (canListen() && server->isStarted()) { // Process server requests
                 server->addInFlightQuery(nodeAddr, uuid);
-                try {
-                    server->onMessageReceived(node, packet, state);
-                    server->removeInFlightQuery(nodeAddr, uuid);
-                } catch (...) { // clean up on error
+                server->scheduleRequest(nodeRef, packet, [this, nodeRef, packet, nodeAddr, uuid]() {
+                    CValidationState state;
+                    try {
+                        server->onMessageReceived(nodeRef.get(), packet, state);
+                    } catch (...) { }
                     server->removeInFlightQuery(nodeAddr, uuid);
-                }
+                    checkDoS(state, nodeRef.get());
+                });
+                return; // DoS is processed with the request
             }
 
-            // Done with request, process DoS and release node
+            // Done with request, process DoS
             checkDoS(state, node);
-            releaseNode(node);
 
         } catch (...) {
             ERR() << strprintf("xrouter query from %s processed with error: ", node->GetAddrName());
             checkDoS(state, node);
-            releaseNode(node);
         }
     });
+
+    if (!queued)
+        LogPrint(BCLog::XROUTER, "xrouter request queue full, dropping packet from peer=%d\n", node->GetId());
+}
+
+//*****************************************************************************
+//*****************************************************************************
+bool App::postRequest(const NodeAddr & client, std::function<void()> work)
+{
+    return requestQueue.push(static_cast<NodeId>(std::hash<std::string>{}(client)), std::move(work));
 }
 
 //*****************************************************************************
@@ -1192,7 +1198,6 @@ std::string App::xrouterCall(enum XRouterCommand command, std::string & uuidRet,
 
         const int timeout = xrsettings->commandTimeout(command, service);
         CKey clientKey; clientKey.Set(cprivkey.begin(), cprivkey.end(), true);
-        boost::thread_group tg;
 
         // Send xrouter request to each selected node
         for (auto & snode : queryNodes) {
@@ -1222,59 +1227,67 @@ std::string App::xrouterCall(enum XRouterCommand command, std::string & uuidRet,
                 // Set the fully qualified service url to the form /xr/BLOCK/xrGetBlockCount
                 const auto & fqUrl = fqServiceToUrl((command == xrService) ? pluginCommandKey(service) // plugin
                                                        : walletCommandKey(service, commandStr, true)); // spv wallet
-                try {
-                    tg.create_thread([uuid,addr,snode,tls,fqUrl,params,feetx,timeout,&clientKey,this]() {
-                        RenameThread("blocknet-xrclientrequest");
-                        if (ShutdownRequested())
-                            return;
-
-                        XRouterReply xrresponse;
-                        try {
-                            std::string data;
-                            if (!params.empty())
-                                data = params.write();
-                            if (tls)
-                                xrresponse = xrouter::CallXRouterUrlSSL(snode.getHost(), snode.getHostAddr().GetPort(), fqUrl,
-                                        data, timeout, clientKey, snode.getSnodePubKey(), feetx);
-                            else
-                                xrresponse = xrouter::CallXRouterUrl(snode.getHost(), snode.getHostAddr().GetPort(), fqUrl,
-                                        data, timeout, clientKey, snode.getSnodePubKey(), feetx);
-                        } catch (std::exception & e) {
-                            UniValue error(UniValue::VOBJ);
-                            error.pushKV("error", e.what());
-                            error.pushKV("code", xrouter::Error::BAD_REQUEST);
-                            error.pushKV("reply", UniValue::VNULL);
-                            queryMgr.addReply(uuid, addr, error.write());
-                            queryMgr.purge(uuid, addr);
-                            return; // failed to connect
-                        }
-
-                        // Do not process if we aren't expecting a result. Also prevent reply malleability (only first reply is accepted)
-                        if (!queryMgr.hasQuery(uuid, addr) || queryMgr.hasReply(uuid, addr))
-                            return; // done, nothing found
-
-                        // Verify servicenode response
-                        CHashWriter hw(SER_GETHASH, 0);
-                        hw << std::vector<unsigned char>(xrresponse.result.begin(), xrresponse.result.end());
-                        const auto hash = hw.GetHash();
-                        CPubKey sigPubKey;
-                        if (snode.getSnodePubKey() != xrresponse.hdrpubkey
-                        || !sigPubKey.RecoverCompact(hash, xrresponse.hdrsignature)
-                        || snode.getSnodePubKey() != sigPubKey) {
-                            UniValue error(UniValue::VOBJ);
-                            error.pushKV("error", "Unable to verify if the service node is valid. Received bad signature on this request.");
-                            error.pushKV("code", xrouter::Error::BAD_SIGNATURE);
-                            error.pushKV("reply", xrresponse.result);
-                            queryMgr.addReply(uuid, addr, error.write());
-                            queryMgr.purge(uuid, addr);
-                            return;
-                        }
+                // Calls to EXR snodes block until the snode replies, they run on the
+                // client request workers instead of a thread per call. Work is queued
+                // per snode so a slow snode doesn't hold up calls to the others.
+                auto call = [uuid,addr,snode,tls,fqUrl,params,feetx,timeout,clientKey,this]() {
+                    if (ShutdownRequested() || !queryMgr.hasQuery(uuid, addr))
+                        return; // query is done (e.g. timed out) before the call started
+
+                    XRouterReply xrresponse;
+                    try {
+                        std::string data;
+                        if (!params.empty())
+                            data = params.write();
+                        if (tls)
+                            xrresponse = xrouter::CallXRouterUrlSSL(snode.getHost(), snode.getHostAddr().GetPort(), fqUrl,
+                                    data, timeout, clientKey, snode.getSnodePubKey(), feetx);
+                        else
+                            xrresponse = xrouter::CallXRouterUrl(snode.getHost(), snode.getHostAddr().GetPort(), fqUrl,
+                                    data, timeout, clientKey, snode.getSnodePubKey(), feetx);
+                    } catch (std::exception & e) {
+                        UniValue error(UniValue::VOBJ);
+                        error.pushKV("error", e.what());
+                        error.pushKV("code", xrouter::Error::BAD_REQUEST);
+                        error.pushKV("reply", UniValue::VNULL);
+                        queryMgr.addReply(uuid, addr, error.write());
+                        queryMgr.purge(uuid, addr);
+                        return; // failed to connect
+                    }
 
-                        // Store the reply
-                        queryMgr.addReply(uuid, addr, xrresponse.result);
+                    // Do not process if we aren't expecting a result. Also prevent reply malleability (only first reply is accepted)
+                    if (!queryMgr.hasQuery(uuid, addr) || queryMgr.hasReply(uuid, addr))
+                        return; // done, nothing found
+
+                    // Verify servicenode response
+                    CHashWriter hw(SER_GETHASH, 0);
+                    hw << std::vector<unsigned char>(xrresponse.result.begin(), xrresponse.result.end());
+                    const auto hash = hw.GetHash();
+                    CPubKey sigPubKey;
+                    if (snode.getSnodePubKey() != xrresponse.hdrpubkey
+                    || !sigPubKey.RecoverCompact(hash, xrresponse.hdrsignature)
+                    || snode.getSnodePubKey() != sigPubKey) {
+                        UniValue error(UniValue::VOBJ);
+                        error.pushKV("error", "Unable to verify if the service node is valid. Received bad signature on this request.");
+                        error.pushKV("code", xrouter::Error::BAD_SIGNATURE);
+                        error.pushKV("reply", xrresponse.result);
+                        queryMgr.addReply(uuid, addr, error.write());
                         queryMgr.purge(uuid, addr);
-                    });
-                } catch (...) { }
+                        return;
+                    }
+
+                    // Store the reply
+                    queryMgr.addReply(uuid, addr, xrresponse.result);
+                    queryMgr.purge(uuid, addr);
+                };
+                if (!clientRequestQueue.push(static_cast<NodeId>(std::hash<std::string>{}(addr)), call)) {
+                    UniValue error(UniValue::VOBJ);
+                    error.pushKV("error", "Too many pending requests to service node " + addr);
+                    error.pushKV("code", xrouter::Error::TOO_MANY_REQUESTS);
+                    error.pushKV("reply", UniValue::VNULL);
+                    queryMgr.addReply(uuid, addr, error.write());
+                    queryMgr.purge(uuid, addr);
+                }
 
                 queryMgr.updateSentRequest(addr, fqService);
             }
@@ -1282,23 +1295,20 @@ std::string App::xrouterCall(enum XRouterCommand command, std::string & uuidRet,
         }
 
         // At this point we need to wait for responses
-        int confirmation_count = 0;
-        auto queryCheckStart = GetTime();
         auto queries = queryMgr.allLocks(uuid);
-        std::vector<NodeAddr> review;
-        for (auto & query : queries)
-            review.push_back(query.first);
 
-        // Check that all replies have arrived, only run as long as timeout
-        while (!ShutdownRequested() && confirmation_count < confs
-            && GetTime() - queryCheckStart < timeout)
-        {
-            boost::this_thread::sleep_for(boost::chrono::milliseconds(5));
-            for (int i = review.size() - 1; i >= 0; --i)
-                if (queryMgr.hasReply(uuid, review[i])) {
-                    ++confirmation_count;
-                    review.erase(review.begin()+i);
-                }
+        // Wait until enough replies have arrived, only run as long as timeout. The wait
+        // wakes up on each reply, the shorter slices only serve to notice a shutdown.
+        int confirmation_count = 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+        while (!ShutdownRequested() && confirmation_count < confs && std::chrono::steady_clock::now() < deadline)
+            confirmation_count = queryMgr.waitForReplies(uuid, confs,
+                    std::min(deadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(250)));
+
+        std::vector<NodeAddr> review; // nodes that didn't reply
+        for (auto & query : queries) {
+            if (!queryMgr.hasReply(uuid, query.first))
+                review.push_back(query.first);
         }
 
         // Clean up
@@ -1846,6 +1856,48 @@ std::string App::getStatus() {
     }
     result.emplace_back("plugins", plugins);
 
+    Object endpoints;
+    for (const auto & item : xbridge::RPCClientPool::instance().stats()) {
+        const auto & s = item.second;
+        Object o;
+        o.emplace_back("requests", static_cast<int64_t>(s.requests));
+        o.emplace_back("errors", static_cast<int64_t>(s.errors));
+        o.emplace_back("connections", static_cast<int64_t>(s.connections));
+        o.emplace_back("avglatency", s.requests > 0 ? static_cast<double>(s.totalLatency) / s.requests / 1000 : 0.0);
+        o.emplace_back("maxlatency", static_cast<double>(s.maxLatency) / 1000);
+        endpoints.emplace_back(item.first, o);
+    }
+    result.emplace_back("rpcendpoints", endpoints);
+
+    if (server && server->isStarted()) {
+        Object connectors;
+        for (const auto & item : server->connectorStats()) {
+            const auto & s = item.second;
+            Object o;
+            o.emplace_back("maxconcurrent", s.maxConcurrent);
+            o.emplace_back("active", static_cast<int64_t>(s.active));
+            o.emplace_back("queued", static_cast<int64_t>(s.queued));
+            o.emplace_back("served", static_cast<int64_t>(s.served));
+            o.emplace_back("rejected", static_cast<int64_t>(s.rejected));
+            o.emplace_back("avgwait", s.served > 0 ? static_cast<double>(s.totalWait) / s.served / 1000 : 0.0);
+            o.emplace_back("maxwait", static_cast<double>(s.maxWait) / 1000);
+            o.emplace_back("avgservice", s.served > 0 ? static_cast<double>(s.totalService) / s.served / 1000 : 0.0);
+            o.emplace_back("maxservice", static_cast<double>(s.maxService) / 1000);
+            connectors.emplace_back(item.first, o);
+        }
+        result.emplace_back("connectors", connectors);
+
+        const auto & c = server->responseCacheStats();
+        Object cache;
+        cache.emplace_back("entries", static_cast<int64_t>(c.entries));
+        cache.emplace_back("bytes", static_cast<int64_t>(c.bytes));
+        cache.emplace_back("maxbytes", static_cast<int64_t>(c.maxBytes));
+        cache.emplace_back("hits", static_cast<int64_t>(c.hits));
+        cache.emplace_back("misses", static_cast<int64_t>(c.misses));
+        cache.emplace_back("evictions", static_cast<int64_t>(c.evictions));
+        result.emplace_back("replycache", cache);
+    }
+
     return json_spirit::write_string(Value(result), json_spirit::pretty_print, 8);
 }
 
@@ -13,6 +13,7 @@
 #include <xrouter/xrouterutils.h>
 
 #include <banman.h>
+#include <dispatchqueue.h>
 #include <hash.h>
 #include <key_io.h>
 #include <net.h>
@@ -317,6 +318,15 @@ public:
      * @return true if wallets loaded, otherwise false
      */
     bool createConnectors();
+
+    /**
+     * Queues work for a client request on the request threads, e.g. a request
+     * resumed by a connector scheduler. Returns false if the queue is full.
+     * @param client
+     * @param work
+     * @return
+     */
+    bool postRequest(const NodeAddr & client, std::function<void()> work);
     
     /**
      * @brief returns status json object
@@ -747,7 +757,8 @@ private:
     boost::filesystem::path xrouterpath;
     bool xrouterIsReady{false};
 
-    boost::thread_group requestHandlers;
+    PeerDispatchQueue requestQueue{"xrrequest", XROUTER_MAX_QUEUED_REQUESTS, XROUTER_MAX_QUEUED_PEER_REQUESTS};
+    PeerDispatchQueue clientRequestQueue{"xrclient", XROUTER_MAX_QUEUED_REQUESTS, XROUTER_MAX_QUEUED_PEER_REQUESTS};
     std::deque<std::shared_ptr<boost::asio::io_service> > ioservices;
     std::deque<std::shared_ptr<boost::asio::io_service::work> > ioworkers;
 
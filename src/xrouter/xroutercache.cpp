@@ -0,0 +1,103 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <xrouter/xroutercache.h>
+
+#include <util/time.h>
+
+#include <iterator>
+
+namespace xrouter {
+
+/** Approximate bookkeeping cost of an entry (list node, index node, strings) */
+static const size_t ENTRY_OVERHEAD = 128;
+
+size_t ResponseCache::Entry::size() const {
+    return key.size() * 2 + reply.size() + ENTRY_OVERHEAD; // key is stored twice, in the entry and the index
+}
+
+bool ResponseCache::get(const std::string & key, std::string & reply) {
+    LOCK(mu);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        ++misses;
+        return false;
+    }
+    if (it->second->expires <= GetTime()) {
+        erase(it->second);
+        ++misses;
+        return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    reply = it->second->reply;
+    ++hits;
+    return true;
+}
+
+bool ResponseCache::peek(const std::string & key, std::string & reply) {
+    LOCK(mu);
+    auto it = index.find(key);
+    if (it == index.end() || it->second->expires <= GetTime())
+        return false;
+    reply = it->second->reply;
+    return true;
+}
+
+void ResponseCache::put(const std::string & key, const std::string & reply, const int64_t ttl) {
+    if (ttl <= 0)
+        return;
+    Entry entry{key, reply, GetTime() + ttl};
+    const size_t size = entry.size();
+
+    LOCK(mu);
+    auto it = index.find(key);
+    if (it != index.end())
+        erase(it->second);
+    if (size > maxBytes)
+        return;
+    entries.push_front(std::move(entry));
+    index[key] = entries.begin();
+    bytes += size;
+    evict();
+}
+
+void ResponseCache::setMaxBytes(const size_t maxBytes) {
+    LOCK(mu);
+    this->maxBytes = maxBytes;
+    evict();
+}
+
+void ResponseCache::clear() {
+    LOCK(mu);
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+ResponseCacheStats ResponseCache::stats() {
+    LOCK(mu);
+    ResponseCacheStats s;
+    s.entries = entries.size();
+    s.bytes = bytes;
+    s.maxBytes = maxBytes;
+    s.hits = hits;
+    s.misses = misses;
+    s.evictions = evictions;
+    return s;
+}
+
+void ResponseCache::erase(EntryIt it) {
+    bytes -= it->size();
+    index.erase(it->key);
+    entries.erase(it);
+}
+
+void ResponseCache::evict() {
+    while (bytes > maxBytes && !entries.empty()) {
+        erase(std::prev(entries.end()));
+        ++evictions;
+    }
+}
+
+} // namespace xrouter
@@ -0,0 +1,106 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BLOCKNET_XROUTER_XROUTERCACHE_H
+#define BLOCKNET_XROUTER_XROUTERCACHE_H
+
+#include <sync.h>
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace xrouter {
+
+/**
+ * Counters for the server response cache.
+ */
+struct ResponseCacheStats {
+    size_t entries{0};
+    size_t bytes{0};
+    size_t maxBytes{0};
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0}; // entries dropped to stay under maxBytes
+};
+
+/**
+ * Caches the replies the server gets from wallet connectors. Each reply
+ * expires after its own ttl. The memory used by the cached replies is
+ * capped, the least recently used replies are dropped to make room.
+ */
+class ResponseCache {
+public:
+    explicit ResponseCache(size_t maxBytes = 0) : maxBytes(maxBytes) {}
+
+    /**
+     * Returns true and the reply if the key is cached and hasn't expired.
+     * @param key
+     * @param reply
+     * @return
+     */
+    bool get(const std::string & key, std::string & reply);
+
+    /**
+     * Same as get but doesn't count as a hit or miss or touch the entry.
+     * @param key
+     * @param reply
+     * @return
+     */
+    bool peek(const std::string & key, std::string & reply);
+
+    /**
+     * Caches the reply for ttl seconds, nothing is cached if ttl isn't
+     * positive or the reply doesn't fit in the cache.
+     * @param key
+     * @param reply
+     * @param ttl
+     */
+    void put(const std::string & key, const std::string & reply, int64_t ttl);
+
+    /**
+     * Sets the memory cap (0 disables the cache) and drops the replies
+     * that no longer fit.
+     * @param bytes
+     */
+    void setMaxBytes(size_t bytes);
+
+    /**
+     * Drops all replies.
+     */
+    void clear();
+
+    /**
+     * Returns the cache counters.
+     * @return
+     */
+    ResponseCacheStats stats();
+
+private:
+    struct Entry {
+        std::string key;
+        std::string reply;
+        int64_t expires;
+        size_t size() const;
+    };
+    typedef std::list<Entry>::iterator EntryIt;
+
+    void erase(EntryIt it) EXCLUSIVE_LOCKS_REQUIRED(mu);
+    void evict() EXCLUSIVE_LOCKS_REQUIRED(mu);
+
+private:
+    Mutex mu;
+    size_t maxBytes GUARDED_BY(mu);
+    size_t bytes GUARDED_BY(mu){0};
+    std::list<Entry> entries GUARDED_BY(mu); // most recently used first
+    std::unordered_map<std::string, EntryIt> index GUARDED_BY(mu);
+    uint64_t hits GUARDED_BY(mu){0};
+    uint64_t misses GUARDED_BY(mu){0};
+    uint64_t evictions GUARDED_BY(mu){0};
+};
+
+} // namespace xrouter
+
+#endif // BLOCKNET_XROUTER_XROUTERCACHE_H
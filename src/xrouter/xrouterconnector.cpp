@@ -3,3 +3,80 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <xrouter/xrouterconnector.h>
+
+#include <xrouter/xrouterdef.h>
+#include <xrouter/xrouterlogger.h>
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace xrouter
+{
+
+std::vector<std::string> WalletConnectorXRouter::callRPCs(const std::vector<std::pair<std::string, Array>> & calls) const
+{
+    if (calls.size() < 2 || batchUnsupported)
+        return callRPCsParallel(calls);
+
+    std::vector<std::string> replies;
+    replies.reserve(calls.size());
+    for (size_t i = 0; i < calls.size(); i += XROUTER_RPC_BATCH_SIZE) {
+        const std::vector<std::pair<std::string, Array>> batch(calls.begin() + i,
+                calls.begin() + std::min<size_t>(i + XROUTER_RPC_BATCH_SIZE, calls.size()));
+        std::vector<std::string> batchReplies;
+        bool batched{false};
+        if (!batchUnsupported) {
+            try {
+                batched = CallRPCBatch(m_user, m_passwd, m_ip, m_port, batch, batchReplies, jsonver, contenttype);
+                if (!batched) {
+                    WARN() << "Wallet " << currency << " doesn't support JSON-RPC batch requests, "
+                           << "using concurrent requests instead";
+                    batchUnsupported = true;
+                }
+            } catch (std::exception & e) {
+                // Not a definitive answer, only this batch falls back to concurrent requests
+                WARN() << "Wallet " << currency << " JSON-RPC batch request failed, "
+                       << "retrying with concurrent requests: " << e.what();
+            }
+        }
+        if (!batched)
+            batchReplies = callRPCsParallel(batch);
+        replies.insert(replies.end(), batchReplies.begin(), batchReplies.end());
+    }
+    return replies;
+}
+
+std::vector<std::string> WalletConnectorXRouter::callRPCsParallel(const std::vector<std::pair<std::string, Array>> & calls) const
+{
+    std::vector<std::string> replies(calls.size());
+    std::vector<std::exception_ptr> errors(calls.size());
+    std::atomic<size_t> next{0};
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < calls.size(); i = next++) {
+            try {
+                replies[i] = CallRPC(m_user, m_passwd, m_ip, m_port, calls[i].first, calls[i].second, jsonver, contenttype);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const size_t count = std::min<size_t>(XROUTER_RPC_PARALLEL_CALLS, calls.size());
+    for (size_t i = 1; i < count; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto & t : threads)
+        t.join();
+
+    // Report the first failed call, like a sequential run would
+    for (const auto & e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+    return replies;
+}
+
+} // namespace xrouter
@@ -7,8 +7,10 @@
 
 #include <xrouter/xrouterutils.h>
 
+#include <atomic>
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace xrouter
@@ -170,6 +172,24 @@ public:
     virtual std::string              decodeRawTransaction(const std::string & hex) const = 0;
     virtual std::string              convertTimeToBlockCount(const std::string & timestamp) const = 0;
     virtual std::string              getBalance(const std::string & address) const = 0;
+
+protected:
+    /**
+     * Runs the calls on the wallet and returns the replies in call order.
+     * The calls are sent in JSON-RPC batches if the wallet supports them,
+     * otherwise they're spread over XROUTER_RPC_PARALLEL_CALLS concurrent
+     * requests. A batch that fails without the wallet rejecting batches is
+     * retried with concurrent requests.
+     * @param calls Method and params of each call
+     * @return
+     */
+    std::vector<std::string> callRPCs(const std::vector<std::pair<std::string, Array>> & calls) const;
+
+private:
+    std::vector<std::string> callRPCsParallel(const std::vector<std::pair<std::string, Array>> & calls) const;
+
+private:
+    mutable std::atomic<bool> batchUnsupported{false};
 };
 
 } // namespace xrouter
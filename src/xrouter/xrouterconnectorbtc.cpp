@@ -99,12 +99,17 @@ std::vector<std::string> BtcWalletConnectorXRouter::getBlocks(const std::vector<
     static const std::string commandGB("getblock");
 
     std::set<std::string> unique{blockHashes.begin(), blockHashes.end()};
-    std::map<std::string, std::string> results;
-    std::vector<std::string> list;
+    std::vector<std::pair<std::string, Array>> calls;
+    for (const auto & hash : unique)
+        calls.emplace_back(commandGB, Array{ hash });
 
+    const auto & replies = callRPCs(calls);
+    std::map<std::string, std::string> results;
+    auto it = replies.begin();
     for (const auto & hash : unique)
-        results[hash] = getBlock(hash);
+        results[hash] = *it++;
 
+    std::vector<std::string> list;
     for (const auto & hash : blockHashes)
         list.push_back(results[hash]);
 
@@ -135,12 +140,35 @@ std::vector<std::string> BtcWalletConnectorXRouter::getTransactions(const std::v
     static const std::string commandDRT("decoderawtransaction");
 
     std::set<std::string> unique{txHashes.begin(), txHashes.end()};
-    std::map<std::string, std::string> results;
-    std::vector<std::string> list;
-
+    std::vector<std::pair<std::string, Array>> calls;
     for (const auto & hash : unique)
-        results[hash] = getTransaction(hash);
+        calls.emplace_back(commandGRT, Array{ hash });
+    const auto & rawTrs = callRPCs(calls);
+
+    // Decode the raw transactions, errors are returned as is
+    std::map<std::string, std::string> results;
+    std::vector<std::string> decode;
+    calls.clear();
+    auto it = rawTrs.begin();
+    for (const auto & hash : unique) {
+        const auto & rawTr = *it++;
+        if (hasError(rawTr)) {
+            results[hash] = rawTr;
+            continue;
+        }
+        const auto & rawTr_val = getResult(rawTr);
+        if (rawTr_val.type() != str_type) {
+            results[hash] = "";
+            continue;
+        }
+        calls.emplace_back(commandDRT, Array{ rawTr_val.get_str() });
+        decode.push_back(hash);
+    }
+    const auto & decoded = callRPCs(calls);
+    for (size_t i = 0; i < decode.size(); ++i)
+        results[decode[i]] = decoded[i];
 
+    std::vector<std::string> list;
     for (const auto & hash : txHashes)
         list.push_back(results[hash]);
 
@@ -159,7 +187,6 @@ std::vector<std::string> BtcWalletConnectorXRouter::getTransactionsBloomFilter(c
     static const std::string commandGBH("getblockhash");
     static const std::string commandGB("getblock");
     static const std::string commandGRT("getrawtransaction");
-    static const std::string commandDRT("decoderawtransaction");
 
     CBloomFilter ft;
     stream >> ft;
@@ -175,32 +202,39 @@ std::vector<std::string> BtcWalletConnectorXRouter::getTransactionsBloomFilter(c
         throw XRouterError("Too many blocks requested", xrouter::INVALID_PARAMETERS);
     }
     
+    std::vector<std::pair<std::string, Array>> calls;
     for (int id = number; id <= blockcount; id++)
-    {
-        const auto & blockHashObj = CallRPC(m_user, m_passwd, m_ip, m_port, commandGBH, { id }, jsonver, contenttype);
-        const auto & hash = getResult(blockHashObj).get_str();
-        const auto & blockObj = CallRPC(m_user, m_passwd, m_ip, m_port, commandGB, { hash }, jsonver, contenttype);
-        Object block = getResult(blockObj).get_obj();
+        calls.emplace_back(commandGBH, Array{ id });
+    const auto & blockHashObjs = callRPCs(calls);
 
+    calls.clear();
+    for (const auto & blockHashObj : blockHashObjs)
+        calls.emplace_back(commandGB, Array{ getResult(blockHashObj).get_str() });
+    const auto & blockObjs = callRPCs(calls);
+
+    calls.clear();
+    for (const auto & blockObj : blockObjs) {
+        Object block = getResult(blockObj).get_obj();
         Array txs = find_value(block, "tx").get_array();
+        for (const auto & j : txs)
+            calls.emplace_back(commandGRT, Array{ Value(j).get_str() });
+    }
+    const auto & rawTrObjs = callRPCs(calls);
 
-        for (const auto & j : txs) {
-            const auto & txid = Value(j).get_str();
-            const auto & rawTrObj = CallRPC(m_user, m_passwd, m_ip, m_port, commandGRT, { txid }, jsonver, contenttype);
-            const auto & txData_str = getResult(rawTrObj).get_str();
+    for (const auto & rawTrObj : rawTrObjs) {
+        const auto & txData_str = getResult(rawTrObj).get_str();
 
-            std::vector<unsigned char> txData(ParseHex(txData_str));
-            CDataStream ssData(txData, SER_NETWORK, PROTOCOL_VERSION);
-            CMutableTransaction mtx;
-            ssData >> mtx;
+        std::vector<unsigned char> txData(ParseHex(txData_str));
+        CDataStream ssData(txData, SER_NETWORK, PROTOCOL_VERSION);
+        CMutableTransaction mtx;
+        ssData >> mtx;
 
-            const CTransaction ctx(mtx);
-            if (filter.IsRelevantAndUpdate(ctx)) {
-                results.push_back(txData_str);
-            }
+        const CTransaction ctx(mtx);
+        if (filter.IsRelevantAndUpdate(ctx)) {
+            results.push_back(txData_str);
         }
     }
-    
+
     return results;
 }
 
@@ -89,10 +89,11 @@ std::string EthWalletConnectorXRouter::getBlock(const std::string & blockHash) c
 
 std::vector<std::string> EthWalletConnectorXRouter::getBlocks(const std::vector<std::string> & blockHashes) const
 {
-    std::vector<std::string> results;
+    static const std::string command("eth_getBlockByHash");
+    std::vector<std::pair<std::string, Array>> calls;
     for (const auto & hash : blockHashes)
-        results.push_back(getBlock(hash));
-    return results;
+        calls.emplace_back(command, Array{ hash, false });
+    return callRPCs(calls);
 }
 
 std::string EthWalletConnectorXRouter::getTransaction(const std::string & trHash) const
@@ -109,10 +110,11 @@ std::string EthWalletConnectorXRouter::decodeRawTransaction(const std::string &
 
 std::vector<std::string> EthWalletConnectorXRouter::getTransactions(const std::vector<std::string> & txHashes) const
 {
-    std::vector<std::string> results;
+    static const std::string command("eth_getTransactionByHash");
+    std::vector<std::pair<std::string, Array>> calls;
     for (const auto & hash : txHashes)
-        results.push_back(getTransaction(hash));
-    return results;
+        calls.emplace_back(command, Array{ hash });
+    return callRPCs(calls);
 }
 
 std::vector<std::string> EthWalletConnectorXRouter::getTransactionsBloomFilter(const int &, CDataStream &, const int &) const
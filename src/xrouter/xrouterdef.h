@@ -15,5 +15,19 @@
 #define XROUTER_DEFAULT_FETCHLIMIT 50
 #define XROUTER_DEFAULT_CONFIRMATIONS 1
 #define XROUTER_TIMER_SECONDS 15
+#define XROUTER_REQUEST_THREADS 8
+#define XROUTER_MAX_QUEUED_REQUESTS 2000
+#define XROUTER_MAX_QUEUED_PEER_REQUESTS 100
+#define XROUTER_CLIENT_REQUEST_THREADS 8 // most workers making client calls to EXR service nodes, each held for the call
+#define XROUTER_MAX_CLIENT_REQUEST_THREADS 1024
+#define XROUTER_RPC_BATCH_SIZE 100   // calls per JSON-RPC batch sent to a wallet
+#define XROUTER_RPC_PARALLEL_CALLS 4 // concurrent calls to a wallet without batch support
+#define XROUTER_CONNECTOR_MAX_CONCURRENT 4     // client requests served at once per wallet connector
+#define XROUTER_CONNECTOR_MAX_QUEUED 64        // client requests waiting per wallet connector
+#define XROUTER_CONNECTOR_MAX_QUEUED_CLIENT 8  // client requests waiting per wallet connector from one client
+#define XROUTER_RESPONSE_CACHE_SIZE 32         // MB of wallet replies cached by the server
+#define XROUTER_RESPONSE_CACHE_SHORT_TTL 5     // seconds, replies that change with new blocks
+#define XROUTER_RESPONSE_CACHE_LONG_TTL 3600   // seconds, replies that no longer change
+#define XROUTER_RESPONSE_CACHE_DEPTH 6         // confirmations after which blocks and transactions are considered final
 
 #endif // BLOCKNET_XROUTER_XROUTERDEF_H
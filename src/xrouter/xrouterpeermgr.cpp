@@ -384,6 +384,34 @@ static bool ProcessMessage(XRouterPeerMgr & peerMgr, CNode* pfrom, const std::st
         return true;
     }
 
+    if (strCommand == NetMsgType::SNLISTBULK) { // handle snode list pages
+        std::vector<sn::ServiceNodePing> pings;
+        sn::ServiceNodeListCursor next;
+        bool more{false};
+        try {
+            vRecv >> pings >> next >> more;
+        } catch (std::exception & e) {
+            LOCK(cs_main);
+            LogPrint(BCLog::NET, "servicenode packet from peer=%d %s processed with error: %s\n",
+                     pfrom->GetId(), pfrom->cleanSubVer, std::string(e.what()));
+            // bad packet, small penalty
+            Misbehaving(pfrom->GetId(), 10);
+            return false;
+        }
+
+        for (const auto & ping : pings) {
+            if (peerMgr.snodeMgr().processPing(ping, true)) // skip validation (no chain available to utilize validation)
+                peerMgr.callHandler(ping.getSnode());
+        }
+
+        // Request the next page, pages must make progress
+        if (more && !pings.empty()) {
+            const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
+            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNLIST, next));
+        }
+        return true;
+    }
+
     // Ignore unknown commands for extensibility
     LogPrint(BCLog::NET, "Unknown command \"%s\" from peer=%d\n", SanitizeString(strCommand), pfrom->GetId());
     return true;
@@ -498,7 +526,8 @@ bool XRouterPeerMgr::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptM
             || strCommand == NetMsgType::PONG
             || strCommand == NetMsgType::NOTFOUND
             || strCommand == NetMsgType::XROUTER
-            || strCommand == NetMsgType::SNLISTPING)
+            || strCommand == NetMsgType::SNLISTPING
+            || strCommand == NetMsgType::SNLISTBULK)
                 fRet = ProcessMessage(*this, pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc, true);
         if (interruptMsgProc)
             return false;
@@ -533,7 +562,7 @@ bool XRouterPeerMgr::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptM
     // If VERACK we're ready to ask for snode list
     if (strCommand == NetMsgType::VERACK) {
         const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
-        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNLIST));
+        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNLIST, sn::ServiceNodeListCursor()));
     }
 
     return true;
@@ -49,8 +49,12 @@ int QueryMgr::addReply(const std::string & id, const NodeAddr & node, const std:
     }
 
     if (replies) { // only handle locks if they exist for this query
+        {
+            LOCK(mu);
+            queries[id][node] = reply; // Assign reply
+        }
+        repliesCond.notify_all();
         boost::mutex::scoped_lock l(*qcond.first);
-        queries[id][node] = reply; // Assign reply
         qcond.second->notify_all();
     }
 
@@ -58,6 +62,16 @@ int QueryMgr::addReply(const std::string & id, const NodeAddr & node, const std:
     return queries.count(id);
 }
 
+int QueryMgr::waitForReplies(const std::string & id, const int count, const std::chrono::steady_clock::time_point deadline) {
+    WAIT_LOCK(mu, lock);
+    auto received = [this, &id]() -> int {
+        auto it = queries.find(id);
+        return it != queries.end() ? static_cast<int>(it->second.size()) : 0;
+    };
+    repliesCond.wait_until(lock, deadline, [&]() { return received() >= count; });
+    return received();
+}
+
 int QueryMgr::reply(const std::string & id, const NodeAddr & node, std::string & reply) {
     LOCK(mu);
 
@@ -12,6 +12,7 @@
 #include <xrouter/xrouterutils.h>
 
 #include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -46,6 +47,16 @@ public:
      */
     int addReply(const std::string & id, const NodeAddr & node, const std::string & reply);
 
+    /**
+     * Waits until the query with specified id has at least count replies
+     * or the deadline passes. Wakes up as soon as a reply arrives.
+     * @param id
+     * @param count
+     * @param deadline
+     * @return Number of replies received for the query.
+     */
+    int waitForReplies(const std::string & id, int count, std::chrono::steady_clock::time_point deadline);
+
     /**
      * Fetch a reply. This method returns the number of matching replies.
      * @param id
@@ -217,6 +228,7 @@ private:
 
 private:
     Mutex mu;
+    std::condition_variable repliesCond; // notified on each reply, used with mu
     std::map<std::string, std::map<NodeAddr, QueryCondition> > queriesLocks;
     std::map<std::string, std::map<NodeAddr, QueryReply> > queries;
     std::map<NodeAddr, std::map<std::string, std::chrono::time_point<std::chrono::system_clock> > > queriesLastSent;
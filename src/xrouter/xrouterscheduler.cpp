@@ -0,0 +1,197 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <xrouter/xrouterscheduler.h>
+
+#include <tinyformat.h>
+#include <util/time.h>
+#include <xrouter/xroutererror.h>
+
+#include <algorithm>
+
+namespace xrouter {
+
+ConnectorScheduler::ConnectorScheduler(const std::string & currency, const int maxConcurrent, const size_t maxQueued,
+                                       const size_t maxQueuedPerClient, const int maxWait, Post post)
+    : currency(currency)
+    , maxConcurrent(static_cast<size_t>(std::max(maxConcurrent, 1)))
+    , maxQueued(maxQueued)
+    , maxQueuedPerClient(maxQueuedPerClient)
+    , maxWait(maxWait)
+    , post(std::move(post))
+{
+    counters.maxConcurrent = static_cast<int>(this->maxConcurrent);
+}
+
+void ConnectorScheduler::submit(const NodeAddr & client, Work work, Reject reject) {
+    std::vector<Request> expired;
+    bool runNow{false};
+    bool refused{false};
+    bool shuttingDown{false};
+    {
+        LOCK(mu);
+        if (stopped) {
+            shuttingDown = true;
+        } else {
+            expire(expired);
+            if (active < maxConcurrent && queued == 0) {
+                ++active;
+                runNow = true;
+            } else {
+                auto it = queues.find(client);
+                if (queued >= maxQueued || (it != queues.end() && it->second.size() >= maxQueuedPerClient)) {
+                    ++counters.rejected;
+                    refused = true;
+                } else {
+                    auto & q = queues[client];
+                    if (q.empty())
+                        ready.push_back(client);
+                    q.push_back({client, std::move(work), std::move(reject), GetTimeMicros()});
+                    ++queued;
+                }
+            }
+        }
+    }
+
+    std::vector<Request> granted;
+    dispatch(granted, expired);
+    if (runNow) {
+        run(work, GetTimeMicros());
+    } else if (shuttingDown) {
+        reject(shutdownError());
+    } else if (refused) {
+        reject(XRouterError(strprintf("Too many requests queued for %s, try again later", currency),
+                            xrouter::TOO_MANY_REQUESTS));
+    }
+}
+
+void ConnectorScheduler::run(const Work & work, const int64_t started) {
+    try {
+        work();
+    } catch (...) {
+        release(started, true);
+        throw;
+    }
+    release(started, true);
+}
+
+void ConnectorScheduler::release(const int64_t started, const bool served) {
+    const int64_t elapsed = GetTimeMicros() - started;
+    std::vector<Request> granted;
+    std::vector<Request> expired;
+    {
+        LOCK(mu);
+        --active;
+        if (served) {
+            ++counters.served;
+            counters.totalService += elapsed;
+            counters.maxService = std::max(counters.maxService, elapsed);
+        } else {
+            ++counters.rejected;
+        }
+        grant(granted, expired);
+    }
+    dispatch(granted, expired);
+}
+
+void ConnectorScheduler::grant(std::vector<Request> & granted, std::vector<Request> & expired) {
+    expire(expired);
+    while (!stopped && active < maxConcurrent && !ready.empty()) {
+        // Let the next client in line through, a client with more requests
+        // waiting goes to the back of the line.
+        const NodeAddr client = ready.front();
+        ready.pop_front();
+        auto it = queues.find(client);
+        granted.push_back(std::move(it->second.front()));
+        it->second.pop_front();
+        if (it->second.empty())
+            queues.erase(it);
+        else
+            ready.push_back(client);
+        --queued;
+        ++active;
+        const int64_t wait = GetTimeMicros() - granted.back().queued;
+        counters.totalWait += wait;
+        counters.maxWait = std::max(counters.maxWait, wait);
+    }
+}
+
+void ConnectorScheduler::expire(std::vector<Request> & expired) {
+    if (queued == 0)
+        return;
+    // Each client's queue is in arrival order, expired requests are at the front
+    const int64_t deadline = GetTimeMicros() - static_cast<int64_t>(maxWait) * 1000000;
+    for (auto it = queues.begin(); it != queues.end(); ) {
+        auto & q = it->second;
+        while (!q.empty() && q.front().queued < deadline) {
+            expired.push_back(std::move(q.front()));
+            q.pop_front();
+            --queued;
+            ++counters.rejected;
+        }
+        if (q.empty()) {
+            ready.erase(std::remove(ready.begin(), ready.end(), it->first), ready.end());
+            it = queues.erase(it);
+        } else
+            ++it;
+    }
+}
+
+void ConnectorScheduler::dispatch(std::vector<Request> & granted, std::vector<Request> & expired) {
+    for (auto & request : expired) {
+        try {
+            request.reject(XRouterError(strprintf("Timed out waiting for the %s connector after %d seconds",
+                                                  currency, maxWait), xrouter::SERVER_TIMEOUT));
+        } catch (...) { }
+    }
+    for (auto & request : granted) {
+        // The request holds its slot until the posted work has run
+        auto self = shared_from_this();
+        const int64_t started = GetTimeMicros();
+        const Work work = std::move(request.work);
+        const bool posted = post(request.client, [self, work, started]() { self->run(work, started); });
+        if (posted)
+            continue;
+        release(started, false);
+        try {
+            request.reject(XRouterError(strprintf("Too many requests queued for %s, try again later", currency),
+                                        xrouter::TOO_MANY_REQUESTS));
+        } catch (...) { }
+    }
+}
+
+void ConnectorScheduler::stop() {
+    std::vector<Request> stopping;
+    {
+        LOCK(mu);
+        stopped = true;
+        for (auto & item : queues) {
+            for (auto & request : item.second)
+                stopping.push_back(std::move(request));
+        }
+        queues.clear();
+        ready.clear();
+        queued = 0;
+    }
+    for (auto & request : stopping) {
+        try {
+            request.reject(shutdownError());
+        } catch (...) { }
+    }
+}
+
+XRouterError ConnectorScheduler::shutdownError() const {
+    return XRouterError("Internal Server Error: Connector for " + currency + " is shutting down",
+                        xrouter::INTERNAL_SERVER_ERROR);
+}
+
+ConnectorSchedulerStats ConnectorScheduler::stats() {
+    LOCK(mu);
+    ConnectorSchedulerStats s = counters;
+    s.active = active;
+    s.queued = queued;
+    return s;
+}
+
+} // namespace xrouter
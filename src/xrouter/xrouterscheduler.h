@@ -0,0 +1,121 @@
+// Copyright (c) 2020 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BLOCKNET_XROUTER_XROUTERSCHEDULER_H
+#define BLOCKNET_XROUTER_XROUTERSCHEDULER_H
+
+#include <sync.h>
+#include <xrouter/xroutererror.h>
+#include <xrouter/xrouterutils.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace xrouter {
+
+/**
+ * Counters for the calls scheduled on a wallet connector.
+ */
+struct ConnectorSchedulerStats {
+    int maxConcurrent{0};
+    size_t active{0};         // calls running
+    size_t queued{0};         // calls waiting for a slot
+    uint64_t served{0};       // calls completed
+    uint64_t rejected{0};     // calls refused (queue full or wait timed out)
+    int64_t totalWait{0};     // microseconds
+    int64_t maxWait{0};       // microseconds
+    int64_t totalService{0};  // microseconds
+    int64_t maxService{0};    // microseconds
+};
+
+/**
+ * Schedules the client requests made to a wallet connector. Up to
+ * maxConcurrent requests run at once, the rest wait in a queue per client
+ * and are let through round-robin, so one client's burst of slow calls
+ * doesn't hold up everybody else's. Waiting requests don't hold a thread,
+ * they're kept as work and handed to post once it's the client's turn.
+ * Requests are refused with TOO_MANY_REQUESTS once the queue (or the
+ * client's share of it) is full and with SERVER_TIMEOUT if they wait
+ * longer than maxWait seconds.
+ */
+class ConnectorScheduler : public std::enable_shared_from_this<ConnectorScheduler> {
+public:
+    typedef std::function<void()> Work;
+    typedef std::function<void(const XRouterError & error)> Reject;
+    typedef std::function<bool(const NodeAddr & client, Work work)> Post;
+
+    /**
+     * @param currency
+     * @param maxConcurrent
+     * @param maxQueued
+     * @param maxQueuedPerClient
+     * @param maxWait Seconds
+     * @param post Runs a queued request on a worker thread, returns false if it can't
+     */
+    ConnectorScheduler(const std::string & currency, int maxConcurrent, size_t maxQueued,
+                       size_t maxQueuedPerClient, int maxWait, Post post);
+
+    /**
+     * Runs the client's request. The work runs on the calling thread if a slot
+     * is free, otherwise it's queued and posted when the client's turn comes.
+     * If the request is refused reject is called instead.
+     * @param client
+     * @param work
+     * @param reject
+     */
+    void submit(const NodeAddr & client, Work work, Reject reject);
+
+    /**
+     * Refuses new requests and rejects the queued ones.
+     */
+    void stop();
+
+    /**
+     * Returns the scheduler counters.
+     * @return
+     */
+    ConnectorSchedulerStats stats();
+
+private:
+    struct Request {
+        NodeAddr client;
+        Work work;
+        Reject reject;
+        int64_t queued; // microseconds
+    };
+
+    void run(const Work & work, int64_t started);
+    void release(int64_t started, bool served);
+    void grant(std::vector<Request> & granted, std::vector<Request> & expired) EXCLUSIVE_LOCKS_REQUIRED(mu);
+    void expire(std::vector<Request> & expired) EXCLUSIVE_LOCKS_REQUIRED(mu);
+    void dispatch(std::vector<Request> & granted, std::vector<Request> & expired);
+    XRouterError shutdownError() const;
+
+private:
+    const std::string currency;
+    const size_t maxConcurrent;
+    const size_t maxQueued;
+    const size_t maxQueuedPerClient;
+    const int maxWait;
+    const Post post;
+
+    Mutex mu;
+    std::map<NodeAddr, std::deque<Request>> queues GUARDED_BY(mu);
+    std::deque<NodeAddr> ready GUARDED_BY(mu);
+    size_t queued GUARDED_BY(mu){0};
+    size_t active GUARDED_BY(mu){0};
+    bool stopped GUARDED_BY(mu){false};
+    ConnectorSchedulerStats counters GUARDED_BY(mu);
+};
+
+typedef std::shared_ptr<ConnectorScheduler> ConnectorSchedulerPtr;
+
+} // namespace xrouter
+
+#endif // BLOCKNET_XROUTER_XROUTERSCHEDULER_H
@@ -28,6 +28,59 @@
 namespace xrouter
 {  
 
+namespace
+{
+    std::string CacheKey(const std::string & currency, XRouterCommand command, const std::vector<std::string> & params)
+    {
+        return currency + xrdelimiter + XRouterCommand_ToString(command) + xrdelimiter + boost::algorithm::join(params, ",");
+    }
+
+    /**
+     * Returns true and the "result" value if the connector reply is a
+     * successful rpc reply.
+     */
+    bool ReplyResult(const std::string & reply, UniValue & result)
+    {
+        UniValue uv;
+        if (!uv.read(reply) || !uv.isObject() || !find_value(uv, "error").isNull())
+            return false;
+        result = find_value(uv, "result");
+        return !result.isNull();
+    }
+
+    /** Cache time of replies that change with every block (e.g. block count). */
+    int64_t ShortTtl(const std::string & reply)
+    {
+        UniValue result;
+        return ReplyResult(reply, result) ? XROUTER_RESPONSE_CACHE_SHORT_TTL : 0;
+    }
+
+    /**
+     * Cache time of block and transaction replies. Blocks looked up by hash
+     * and decoded transactions don't change, except for the confirmations
+     * reported by bitcoin based wallets and the block fields of pending eth
+     * transactions. Replies with fewer than XROUTER_RESPONSE_CACHE_DEPTH
+     * confirmations may still be reorganized away and are only cached for a
+     * short time, settled ones are cached for the long time.
+     */
+    int64_t SettledTtl(const std::string & reply)
+    {
+        UniValue result;
+        if (!ReplyResult(reply, result))
+            return 0;
+        if (!result.isObject())
+            return XROUTER_RESPONSE_CACHE_LONG_TTL;
+        if (result.exists("confirmations")) {
+            const UniValue & confirmations = find_value(result, "confirmations");
+            if (!confirmations.isNum() || confirmations.get_int64() < XROUTER_RESPONSE_CACHE_DEPTH)
+                return XROUTER_RESPONSE_CACHE_SHORT_TTL;
+        }
+        if (result.exists("blockNumber") && find_value(result, "blockNumber").isNull())
+            return XROUTER_RESPONSE_CACHE_SHORT_TTL; // pending eth transaction
+        return XROUTER_RESPONSE_CACHE_LONG_TTL;
+    }
+}
+
 //*****************************************************************************
 //*****************************************************************************
 bool XRouterServer::start()
@@ -46,12 +99,19 @@ bool XRouterServer::start()
 bool XRouterServer::stop()
 {
     LOCK(_lock);
+    for (auto & item : schedulers)
+        item.second->stop();
     connectors.clear();
-    connectorLocks.clear();
+    schedulers.clear();
+    responseCache.clear();
     return true;
 }
 
 bool XRouterServer::createConnectors() {
+    const int cacheSize = std::max(App::instance().xrSettings()->replyCacheSize(), 0);
+    responseCache.clear();
+    responseCache.setMaxBytes(static_cast<size_t>(cacheSize) * 1024 * 1024);
+
     try {
         Settings & s = settings();
         std::vector<std::string> wallets = App::instance().xrSettings()->getWallets();
@@ -112,9 +172,18 @@ bool XRouterServer::createConnectors() {
 
 void XRouterServer::addConnector(const WalletConnectorXRouterPtr & conn)
 {
+    auto xrsettings = App::instance().xrSettings();
+    auto scheduler = std::make_shared<ConnectorScheduler>(conn->currency,
+            xrsettings->maxConcurrentCalls(conn->currency),
+            static_cast<size_t>(std::max(xrsettings->maxQueuedCalls(conn->currency), 0)),
+            XROUTER_CONNECTOR_MAX_QUEUED_CLIENT, XROUTER_DEFAULT_TIMEOUT,
+            [](const NodeAddr & client, ConnectorScheduler::Work work) {
+                return App::instance().postRequest(client, std::move(work));
+            });
+
     LOCK(_lock);
     connectors[conn->currency] = conn;
-    connectorLocks[conn->currency] = std::make_shared<boost::mutex>();
+    schedulers[conn->currency] = scheduler; // requests queued on a replaced scheduler still complete
 }
 
 WalletConnectorXRouterPtr XRouterServer::connectorByCurrency(const std::string & currency) const
@@ -162,6 +231,44 @@ bool XRouterServer::checkFeePayment(const NodeAddr & nodeAddr, const std::string
     return true;
 }
 
+//*****************************************************************************
+//*****************************************************************************
+void XRouterServer::scheduleRequest(const std::shared_ptr<CNode> & node, XRouterPacketPtr packet,
+                                    ConnectorScheduler::Work process)
+{
+    ConnectorSchedulerPtr scheduler;
+    switch (packet->command()) {
+        case xrGetBlockCount:
+        case xrGetBlockHash:
+        case xrGetBlock:
+        case xrGetBlocks:
+        case xrGetTransaction:
+        case xrGetTransactions:
+        case xrDecodeRawTransaction:
+        case xrSendTransaction:
+            scheduler = schedulerByCurrency(packet->service());
+            break;
+        default:
+            break;
+    }
+
+    if (!scheduler) {
+        process();
+        return;
+    }
+
+    const auto nodeAddr = node->GetAddrName();
+    const auto uuid = packet->suuid();
+    scheduler->submit(nodeAddr, std::move(process), [this, node, nodeAddr, uuid](const XRouterError & e) {
+        removeInFlightQuery(nodeAddr, uuid);
+        LOG() << e.msg;
+        Object error;
+        error.emplace_back("error", e.msg);
+        error.emplace_back("code", e.code);
+        sendPacketToClient(uuid, json_spirit::write_string(Value(error), true), node.get());
+    });
+}
+
 //*****************************************************************************
 //*****************************************************************************
 void XRouterServer::onMessageReceived(CNode* node, XRouterPacketPtr packet, CValidationState& state)
@@ -347,25 +454,25 @@ void XRouterServer::onMessageReceived(CNode* node, XRouterPacketPtr packet, CVal
             try {
                 switch (command) {
                     case xrGetBlockCount:
-                        reply = parseResult(processGetBlockCount(service, params));
+                        reply = parseResult(processGetBlockCount(nodeAddr, service, params));
                         break;
                     case xrGetBlockHash:
-                        reply = parseResult(processGetBlockHash(service, params));
+                        reply = parseResult(processGetBlockHash(nodeAddr, service, params));
                         break;
                     case xrGetBlock:
-                        reply = parseResult(processGetBlock(service, params));
+                        reply = parseResult(processGetBlock(nodeAddr, service, params));
                         break;
                     case xrGetTransaction:
-                        reply = parseResult(processGetTransaction(service, params));
+                        reply = parseResult(processGetTransaction(nodeAddr, service, params));
                         break;
                     case xrGetBlocks:
-                        reply = parseResult(processGetBlocks(service, params));
+                        reply = parseResult(processGetBlocks(nodeAddr, service, params));
                         break;
                     case xrGetTransactions:
-                        reply = parseResult(processGetTransactions(service, params));
+                        reply = parseResult(processGetTransactions(nodeAddr, service, params));
                         break;
                     case xrDecodeRawTransaction:
-                        reply = parseResult(processDecodeRawTransaction(service, params));
+                        reply = parseResult(processDecodeRawTransaction(nodeAddr, service, params));
                         break;
                     case xrGetBalance:
                         throw XRouterError("This call is not supported: " + fqService, xrouter::UNSUPPORTED_SERVICE);
@@ -373,7 +480,7 @@ void XRouterServer::onMessageReceived(CNode* node, XRouterPacketPtr packet, CVal
                         break;
                     case xrGetTxBloomFilter:
                         throw XRouterError("This call is not supported: " + fqService, xrouter::UNSUPPORTED_SERVICE);
-//                        reply = parseResult(processGetTxBloomFilter(service, params));
+//                        reply = parseResult(processGetTxBloomFilter(nodeAddr, service, params));
                         break;
                     case xrGenerateBloomFilter:
                         throw XRouterError("This call is not supported: " + fqService, xrouter::UNSUPPORTED_SERVICE);
@@ -381,13 +488,13 @@ void XRouterServer::onMessageReceived(CNode* node, XRouterPacketPtr packet, CVal
                         break;
                     case xrGetBlockAtTime:
                         throw XRouterError("This call is not supported: " + fqService, xrouter::UNSUPPORTED_SERVICE);
-//                        reply = parseResult(processConvertTimeToBlockCount(service, params));
+//                        reply = parseResult(processConvertTimeToBlockCount(nodeAddr, service, params));
                         break;
                     case xrGetReply:
                         reply = parseResult(processFetchReply(uuid));
                         break;
                     case xrSendTransaction:
-                        reply = parseResult(processSendTransaction(service, params));
+                        reply = parseResult(processSendTransaction(nodeAddr, service, params));
                         break;
                     default:
                         throw XRouterError("Unknown command " + fqService, xrouter::UNSUPPORTED_SERVICE);
@@ -425,55 +532,60 @@ void XRouterServer::onMessageReceived(CNode* node, XRouterPacketPtr packet, CVal
 
 //*****************************************************************************
 //*****************************************************************************
-std::string XRouterServer::processGetBlockCount(const std::string & currency, const std::vector<std::string> & params) {
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
-        return conn->getBlockCount();
-    }
-
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+std::string XRouterServer::processGetBlockCount(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
+    return cachedCall(CacheKey(currency, xrGetBlockCount, {}), [&]() {
+        return callConnector(nodeAddr, currency, [](const WalletConnectorXRouterPtr & conn) {
+            return conn->getBlockCount();
+        });
+    }, ShortTtl);
 }
 
-std::string XRouterServer::processGetBlockHash(const std::string & currency, const std::vector<std::string> & params) {
+std::string XRouterServer::processGetBlockHash(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
     const auto & blockId = params[0];
 
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
-        uint32_t block_n{0};
-        if (boost::algorithm::starts_with(blockId, "0x")) { // handle hex values (specifically for eth)
-            try {
-                block_n = boost::lexical_cast<uint32_t>(blockId);
-            } catch(...) {
-                throw XRouterError("Failed to parse hex into block number", xrouter::INVALID_PARAMETERS);
-            }
-        } else { // handle integer values
-            try {
-                block_n = boost::lexical_cast<uint32_t>(blockId);
-            } catch (...) {
-                throw XRouterError("Problem with the specified block number, is it a number?", xrouter::INVALID_PARAMETERS);
-            }
+    uint32_t block_n{0};
+    if (boost::algorithm::starts_with(blockId, "0x")) { // handle hex values (specifically for eth)
+        try {
+            block_n = boost::lexical_cast<uint32_t>(blockId);
+        } catch(...) {
+            throw XRouterError("Failed to parse hex into block number", xrouter::INVALID_PARAMETERS);
+        }
+    } else { // handle integer values
+        try {
+            block_n = boost::lexical_cast<uint32_t>(blockId);
+        } catch (...) {
+            throw XRouterError("Problem with the specified block number, is it a number?", xrouter::INVALID_PARAMETERS);
         }
-        return conn->getBlockHash(block_n);
     }
 
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+    // Hashes of blocks buried deeper than the last seen block count won't change
+    int64_t deepHeight{-1};
+    std::string countReply;
+    UniValue count;
+    if (responseCache.peek(CacheKey(currency, xrGetBlockCount, {}), countReply) && ReplyResult(countReply, count) && count.isNum())
+        deepHeight = count.get_int64() - XROUTER_RESPONSE_CACHE_DEPTH;
+
+    return cachedCall(CacheKey(currency, xrGetBlockHash, {std::to_string(block_n)}), [&]() {
+        return callConnector(nodeAddr, currency, [block_n](const WalletConnectorXRouterPtr & conn) {
+            return conn->getBlockHash(block_n);
+        });
+    }, [block_n, deepHeight](const std::string & reply) {
+        const int64_t ttl = ShortTtl(reply);
+        return ttl > 0 && static_cast<int64_t>(block_n) <= deepHeight ? XROUTER_RESPONSE_CACHE_LONG_TTL : ttl;
+    });
 }
 
-std::string XRouterServer::processGetBlock(const std::string & currency, const std::vector<std::string> & params) {
+std::string XRouterServer::processGetBlock(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
     const auto & blockHash = params[0];
 
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
-        return conn->getBlock(blockHash);
-    }
-
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+    return cachedCall(CacheKey(currency, xrGetBlock, {blockHash}), [&]() {
+        return callConnector(nodeAddr, currency, [&blockHash](const WalletConnectorXRouterPtr & conn) {
+            return conn->getBlock(blockHash);
+        });
+    }, SettledTtl);
 }
 
-std::vector<std::string> XRouterServer::processGetBlocks(const std::string & currency, const std::vector<std::string> & params) {
+std::vector<std::string> XRouterServer::processGetBlocks(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
     if (params.empty())
         throw XRouterError("Missing block hashes for " + currency, xrouter::BAD_REQUEST);
 
@@ -483,29 +595,25 @@ std::vector<std::string> XRouterServer::processGetBlocks(const std::string & cur
         throw XRouterError("Too many blocks requested for " + currency + " limit is " +
                            std::to_string(fetchlimit) + " received " + std::to_string(params.size()), xrouter::BAD_REQUEST);
 
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
-        return conn->getBlocks(params);
-    }
-
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+    return cachedCalls(currency, xrGetBlock, params, [&](const std::vector<std::string> & hashes) {
+        return callConnector(nodeAddr, currency, [&hashes](const WalletConnectorXRouterPtr & conn) {
+            return conn->getBlocks(hashes);
+        });
+    });
 }
 
 
-std::string XRouterServer::processGetTransaction(const std::string & currency, const std::vector<std::string> & params) {
+std::string XRouterServer::processGetTransaction(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
     const auto & hash = params[0];
 
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
-        return conn->getTransaction(hash);
-    }
-
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+    return cachedCall(CacheKey(currency, xrGetTransaction, {hash}), [&]() {
+        return callConnector(nodeAddr, currency, [&hash](const WalletConnectorXRouterPtr & conn) {
+            return conn->getTransaction(hash);
+        });
+    }, SettledTtl);
 }
 
-std::vector<std::string> XRouterServer::processGetTransactions(const std::string & currency, const std::vector<std::string> & params) {
+std::vector<std::string> XRouterServer::processGetTransactions(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
     if (params.empty())
         throw XRouterError("Missing transaction hashes for " + currency, xrouter::BAD_REQUEST);
 
@@ -515,43 +623,33 @@ std::vector<std::string> XRouterServer::processGetTransactions(const std::string
         throw XRouterError("Too many transactions requested for " + currency + " limit is " +
                            std::to_string(fetchlimit) + " received " + std::to_string(params.size()), xrouter::BAD_REQUEST);
     
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
-        return conn->getTransactions(params);
-    }
-
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+    return cachedCalls(currency, xrGetTransaction, params, [&](const std::vector<std::string> & hashes) {
+        return callConnector(nodeAddr, currency, [&hashes](const WalletConnectorXRouterPtr & conn) {
+            return conn->getTransactions(hashes);
+        });
+    });
 }
 
-std::string XRouterServer::processDecodeRawTransaction(const std::string & currency, const std::vector<std::string> & params) {
+std::string XRouterServer::processDecodeRawTransaction(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
     const auto & hex = params[0];
 
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
+    return callConnector(nodeAddr, currency, [&hex](const WalletConnectorXRouterPtr & conn) {
         return conn->decodeRawTransaction(hex);
-    }
-
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+    });
 }
 
-std::string XRouterServer::processSendTransaction(const std::string & currency, const std::vector<std::string> & params) {
+std::string XRouterServer::processSendTransaction(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
     const auto & transaction = params[0];
 
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
+    return callConnector(nodeAddr, currency, [&transaction](const WalletConnectorXRouterPtr & conn) {
         return conn->sendTransaction(transaction);
-    }
-
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+    });
 }
 
 //*****************************************************************************
 //*****************************************************************************
 
-std::vector<std::string> XRouterServer::processGetTxBloomFilter(const std::string & currency, const std::vector<std::string> & params) {
+std::vector<std::string> XRouterServer::processGetTxBloomFilter(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
     const auto & filter = params[0];
 
     // 10 is a constant for bloom filters currently
@@ -571,13 +669,9 @@ std::vector<std::string> XRouterServer::processGetTxBloomFilter(const std::strin
     App & app = App::instance();
     int fetchlimit = app.xrSettings()->commandFetchLimit(xrGetTxBloomFilter, currency);
 
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
+    return callConnector(nodeAddr, currency, [number, &stream, fetchlimit](const WalletConnectorXRouterPtr & conn) {
         return conn->getTransactionsBloomFilter(number, stream, fetchlimit);
-    }
-
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+    });
 }
 
 std::string XRouterServer::processGenerateBloomFilter(const std::string & currency, const std::vector<std::string> & params) {
@@ -620,16 +714,12 @@ std::string XRouterServer::processGenerateBloomFilter(const std::string & curren
     return json_spirit::write_string(Value(result), true);
 }
 
-std::string XRouterServer::processConvertTimeToBlockCount(const std::string & currency, const std::vector<std::string> & params) {
+std::string XRouterServer::processConvertTimeToBlockCount(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params) {
     const std::string timestamp(params[0]);
 
-    xrouter::WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
-    if (conn && hasConnectorLock(currency)) {
-        boost::mutex::scoped_lock l(*getConnectorLock(currency));
+    return callConnector(nodeAddr, currency, [&timestamp](const WalletConnectorXRouterPtr & conn) {
         return conn->convertTimeToBlockCount(timestamp);
-    }
-
-    throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+    });
 }
 
 std::string XRouterServer::processGetBalance(const std::string & currency, const std::vector<std::string> & params) {
@@ -950,6 +1040,53 @@ void XRouterServer::runPerformanceTests() {
 //    }
 }
 
+std::string XRouterServer::cachedCall(const std::string & key, const std::function<std::string()> & call,
+                                      const std::function<int64_t(const std::string &)> & ttl)
+{
+    std::string reply;
+    if (responseCache.get(key, reply))
+        return reply;
+    reply = call();
+    responseCache.put(key, reply, ttl(reply));
+    return reply;
+}
+
+std::vector<std::string> XRouterServer::cachedCalls(const std::string & currency, const XRouterCommand command,
+        const std::vector<std::string> & params,
+        const std::function<std::vector<std::string>(const std::vector<std::string> &)> & call)
+{
+    std::vector<std::string> replies(params.size());
+    std::vector<std::string> missing;
+    std::vector<size_t> missingPos;
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (!responseCache.get(CacheKey(currency, command, {params[i]}), replies[i])) {
+            missing.push_back(params[i]);
+            missingPos.push_back(i);
+        }
+    }
+    if (missing.empty())
+        return replies;
+
+    const auto & fetched = call(missing);
+    for (size_t i = 0; i < missing.size() && i < fetched.size(); ++i) {
+        replies[missingPos[i]] = fetched[i];
+        responseCache.put(CacheKey(currency, command, {missing[i]}), fetched[i], SettledTtl(fetched[i]));
+    }
+    return replies;
+}
+
+std::map<std::string, ConnectorSchedulerStats> XRouterServer::connectorStats() {
+    std::map<std::string, ConnectorSchedulerPtr> current;
+    {
+        LOCK(_lock);
+        current = schedulers;
+    }
+    std::map<std::string, ConnectorSchedulerStats> r;
+    for (const auto & item : current)
+        r[item.first] = item.second->stats();
+    return r;
+}
+
 bool XRouterServer::rateLimitExceeded(const std::string & nodeAddr, const std::string & key, const int & rateLimit) {
     auto & app = App::instance();
     return app.rateLimitExceeded(nodeAddr, key, app.getLastRequest(nodeAddr, key), rateLimit);
@@ -5,17 +5,22 @@
 #ifndef BLOCKNET_XROUTER_XROUTERSERVER_H
 #define BLOCKNET_XROUTER_XROUTERSERVER_H
 
+#include <xrouter/xroutercache.h>
 #include <xrouter/xrouterdef.h>
 #include <xrouter/xrouterutils.h>
 #include <xrouter/xrouterconnector.h>
 #include <xrouter/xrouterconnectorbtc.h>
 #include <xrouter/xrouterconnectoreth.h>
+#include <xrouter/xroutererror.h>
+#include <xrouter/xrouterscheduler.h>
 
 #include <consensus/validation.h>
 #include <net.h>
 #include <sync.h>
 #include <validationinterface.h>
 
+#include <functional>
+
 namespace xrouter
 {
 
@@ -61,67 +66,75 @@ public:
     
        /**
      * @brief process xrGetBlockCount call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to query
      * @param params list of parameters
      * @return
      */
-    std::string processGetBlockCount(const std::string & currency, const std::vector<std::string> & params);
+    std::string processGetBlockCount(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process xrGetBlockHash call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to query
      * @param params list of parameters
      * @return
      */
-    std::string processGetBlockHash(const std::string & currency, const std::vector<std::string> & params);
+    std::string processGetBlockHash(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process xrGetBlock call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to query
      * @param params list of parameters
      * @return
      */
-    std::string processGetBlock(const std::string & currency, const std::vector<std::string> & params);
+    std::string processGetBlock(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process xrGetBlocks call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to query
      * @param params list of parameters
      * @return
      */
-    std::vector<std::string> processGetBlocks(const std::string & currency, const std::vector<std::string> & params);
+    std::vector<std::string> processGetBlocks(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process xrGetTransaction call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to query
      * @param params list of parameters
      * @return
      */
-    std::string processGetTransaction(const std::string & currency, const std::vector<std::string> & params);
+    std::string processGetTransaction(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process xrGetAllTransactions call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to query
      * @param params list of parameters
      * @return
      */
-    std::vector<std::string> processGetTransactions(const std::string & currency, const std::vector<std::string> & params);
+    std::vector<std::string> processGetTransactions(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process xrDecodeRawTransaction call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to query
      * @param params list of parameters
      * @return
      */
-    std::string processDecodeRawTransaction(const std::string & currency, const std::vector<std::string> & params);
+    std::string processDecodeRawTransaction(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process xrGetTransactionsBloomFilter call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to query
      * @param params list of parameters
      * @return
      */
-    std::vector<std::string> processGetTxBloomFilter(const std::string & currency, const std::vector<std::string> & params);
+    std::vector<std::string> processGetTxBloomFilter(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process xrGenerateBloomFilter call on service node side
@@ -133,19 +146,21 @@ public:
 
     /**
      * @brief process SendTransaction call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to send transaction on
      * @param params list of parameters
      * @return
      */
-    std::string processSendTransaction(const std::string & currency, const std::vector<std::string> & params);
+    std::string processSendTransaction(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process ConvertTimeToBlockCount call on service node side
+     * @param nodeAddr client making the request
      * @param currency blockchain to query
      * @param params list of parameters
      * @return
      */
-    std::string processConvertTimeToBlockCount(const std::string & currency, const std::vector<std::string> & params);
+    std::string processConvertTimeToBlockCount(const NodeAddr & nodeAddr, const std::string & currency, const std::vector<std::string> & params);
 
     /**
      * @brief process xrGetBalance call on service node side
@@ -221,6 +236,19 @@ public:
      */
     bool createConnectors();
 
+    /**
+     * Runs the client's request once the wallet connector it calls lets the
+     * client through. Requests waiting for the connector don't hold a request
+     * thread, they're resumed on the request queue. Requests that don't call a
+     * wallet connector run right away. If the connector refuses the request the
+     * error is sent to the client and the query is no longer in flight.
+     * @param node
+     * @param packet
+     * @param process handles the request
+     */
+    void scheduleRequest(const std::shared_ptr<CNode> & node, XRouterPacketPtr packet,
+                         ConnectorScheduler::Work process);
+
     /**
      * Returns true if this server has a pending query.
      * @param node
@@ -265,6 +293,20 @@ public:
 
     void runPerformanceTests();
 
+    /**
+     * Returns the request scheduler counters for each connector.
+     * @return
+     */
+    std::map<std::string, ConnectorSchedulerStats> connectorStats();
+
+    /**
+     * Returns the response cache counters.
+     * @return
+     */
+    ResponseCacheStats responseCacheStats() {
+        return responseCache.stats();
+    }
+
 private:
     /**
      * @brief load the connector (class used to communicate with other chains)
@@ -317,11 +359,35 @@ private:
      */
     std::string parseResult(const std::vector<std::string> & resv);
 
+    /**
+     * Returns the cached reply or makes the call and caches its reply.
+     * @param key
+     * @param call
+     * @param ttl returns the number of seconds to cache a reply, 0 if it shouldn't be cached
+     * @return
+     */
+    std::string cachedCall(const std::string & key, const std::function<std::string()> & call,
+                           const std::function<int64_t(const std::string &)> & ttl);
+
+    /**
+     * Returns the reply to command for each of the params. Cached replies
+     * are used where possible, the call is made for the rest.
+     * @param currency
+     * @param command command whose replies are cached for a single param
+     * @param params
+     * @param call fetches the replies for the params missing from the cache
+     * @return
+     */
+    std::vector<std::string> cachedCalls(const std::string & currency, XRouterCommand command,
+                                         const std::vector<std::string> & params,
+                                         const std::function<std::vector<std::string>(const std::vector<std::string> &)> & call);
+
 private:
     bool started{false};
 
     std::map<std::string, WalletConnectorXRouterPtr> connectors;
-    std::map<std::string, std::shared_ptr<boost::mutex> > connectorLocks;
+    std::map<std::string, ConnectorSchedulerPtr> schedulers;
+    ResponseCache responseCache;
 
     std::map<std::string, std::pair<std::string, CAmount> > hashedQueries;
     std::map<std::string, std::chrono::time_point<std::chrono::system_clock> > hashedQueriesDeadlines;
@@ -344,13 +410,28 @@ private:
         LOCK(_lock);
         return hashedQueries.count(uuid);
     }
-    std::shared_ptr<boost::mutex> getConnectorLock(const std::string & currency) {
+    ConnectorSchedulerPtr schedulerByCurrency(const std::string & currency) {
         LOCK(_lock);
-        return connectorLocks[currency];
+        auto it = schedulers.find(currency);
+        return it != schedulers.end() ? it->second : nullptr;
     }
-    bool hasConnectorLock(const std::string & currency) {
-        LOCK(_lock);
-        return connectorLocks.count(currency);
+
+    /**
+     * Runs the call on the currency's connector. The request already holds
+     * a slot on the connector's scheduler, see scheduleRequest.
+     * @param nodeAddr client making the request
+     * @param currency
+     * @param call takes the connector
+     * @return the call's result
+     */
+    template <typename Call>
+    auto callConnector(const NodeAddr & nodeAddr, const std::string & currency, Call call)
+        -> decltype(call(WalletConnectorXRouterPtr()))
+    {
+        WalletConnectorXRouterPtr conn = connectorByCurrency(currency);
+        if (!conn)
+            throw XRouterError("Internal Server Error: No connector for " + currency, xrouter::BAD_CONNECTOR);
+        return call(conn);
     }
 
 };
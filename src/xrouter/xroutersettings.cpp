@@ -482,6 +482,32 @@ int XRouterSettings::configSyncTimeout()
     return res;
 }
 
+int XRouterSettings::maxConcurrentCalls(const std::string & currency)
+{
+    auto res = get<int>("Main.maxconcurrentcalls", XROUTER_CONNECTOR_MAX_CONCURRENT);
+    res = get<int>(currency + ".maxconcurrentcalls", res);
+    return res;
+}
+
+int XRouterSettings::maxQueuedCalls(const std::string & currency)
+{
+    auto res = get<int>("Main.maxqueuedcalls", XROUTER_CONNECTOR_MAX_QUEUED);
+    res = get<int>(currency + ".maxqueuedcalls", res);
+    return res;
+}
+
+int XRouterSettings::replyCacheSize()
+{
+    auto res = get<int>("Main.replycachesize", XROUTER_RESPONSE_CACHE_SIZE);
+    return res;
+}
+
+int XRouterSettings::clientRequestThreads()
+{
+    auto res = get<int>("Main.clientrequestthreads", XROUTER_CLIENT_REQUEST_THREADS);
+    return res;
+}
+
 std::map<std::string, double> XRouterSettings::feeSchedule() {
 
     double fee = defaultFee();
@@ -785,6 +811,21 @@ bool createConf(const boost::filesystem::path & confDir, const bool & skipPlugin
                      "#! timeout is the maximum time in seconds you're willing to wait for an XRouter response"          + eol +
                      "timeout=30"                                                                                        + eol +
                      ""                                                                                                  + eol +
+                     "#! clientrequestthreads is the number of xrouter calls to service nodes that can be in flight"     + eol +
+                     "#! at once, each call holds a thread until the reply or the timeout (1 to 1024). Threads are"      + eol +
+                     "#! started as calls need them."                                                                    + eol +
+                     "#! clientrequestthreads=8"                                                                         + eol +
+                     ""                                                                                                  + eol +
+                     "#! Service nodes only: maxconcurrentcalls is the number of client requests sent to a wallet"       + eol +
+                     "#! at once, maxqueuedcalls is the number of client requests allowed to wait for a wallet."         + eol +
+                     "#! Both can be set per wallet, e.g. [BTC] maxconcurrentcalls=8"                                    + eol +
+                     "#! maxconcurrentcalls=4"                                                                           + eol +
+                     "#! maxqueuedcalls=64"                                                                              + eol +
+                     ""                                                                                                  + eol +
+                     "#! Service nodes only: replycachesize is the memory in MB used to cache wallet replies"            + eol +
+                     "#! to repeated client requests (0 disables the cache)."                                            + eol +
+                     "#! replycachesize=32"                                                                              + eol +
+                     ""                                                                                                  + eol +
                      "#! Optionally set per-call config options:"                                                        + eol +
                      "#! [xrGetBlockCount]"                                                                              + eol +
                      "#! maxfee=0.01"                                                                                    + eol +
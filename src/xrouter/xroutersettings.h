@@ -202,6 +202,10 @@ public:
     int confirmations(XRouterCommand c, std::string currency="", int def=XROUTER_DEFAULT_CONFIRMATIONS); // 1 confirmation default
     std::string paymentAddress(XRouterCommand c, const std::string & service="");
     int configSyncTimeout();
+    int maxConcurrentCalls(const std::string & currency);
+    int maxQueuedCalls(const std::string & currency);
+    int replyCacheSize();
+    int clientRequestThreads();
 
     double defaultFee();
     std::map<std::string, double> feeSchedule();
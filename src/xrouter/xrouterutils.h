@@ -112,6 +112,18 @@ std::string CallRPC(const std::string & rpcuser, const std::string & rpcpasswd,
                            const std::string & rpcip, const std::string & rpcport,
                            const std::string & strMethod, const Array & params,
                            const std::string & jsonver="", const std::string & contenttype="");
+/**
+ * Sends the calls as a single JSON-RPC batch request. The replies (serialized
+ * reply objects) are returned in call order. Returns false if the server
+ * doesn't support batch requests, i.e. it answers the batch with a single
+ * reply. Throws if it can't be reached or the batch reply is invalid or
+ * incomplete.
+ */
+bool CallRPCBatch(const std::string & rpcuser, const std::string & rpcpasswd,
+                           const std::string & rpcip, const std::string & rpcport,
+                           const std::vector<std::pair<std::string, Array>> & calls,
+                           std::vector<std::string> & replies,
+                           const std::string & jsonver="", const std::string & contenttype="");
 
 // Payment functions
 bool createAndSignTransaction(const std::string & address, const CAmount & amount, std::string & raw_tx);